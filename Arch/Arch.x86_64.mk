@@ -58,6 +58,16 @@ RNMAKE_ARCH_CPPFLAGS =
 RNMAKE_ARCH_CFLAGS   =
 RNMAKE_ARCH_CXXFLAGS =
 
+# Supported microarchitecture levels (make march=<level[,level...]>). Shared
+# libraries of each level are made in the glibc-hwcaps/<level> subdirectory of
+# the library directory, from which the dynamic loader (glibc 2.33+) selects
+# the best variant supported by the host at load time.
+RNMAKE_ARCH_MARCH_LEVELS = x86-64-v2 x86-64-v3 x86-64-v4
+
+# $(call march_flags,level)
+# 	Code generation flags of microarchitecture level.
+march_flags = -march=$(1) -mtune=generic
+
 # Build Support Commands
 AR              = ar
 RANLIB          = ranlib
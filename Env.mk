@@ -119,12 +119,100 @@ endif
 
 undefine _prefix
 
+# ------------------------------------------------------------------------------
+# RNMAKE_CACHE_DIR
+#   Prebuilt distribution tree cache directory. A [user@]host:path directory is
+#   accessed with rsync. Undefined or 'off' disables the cache.
+#
+#   Make override:    make cachedir=<path> ...
+#   Fallback default: (disabled)
+# ------------------------------------------------------------------------------
+
+# 'make cachedir=<path> ...' or RNMAKE_CACHE_DIR
+cachedir ?= $(RNMAKE_CACHE_DIR)
+
+# command-line variable=value cannot be modified
+_cachedir = $(cachedir)
+
+ifeq "$(_cachedir)" "off"
+  undefine RNMAKE_CACHE_DIR
+else ifneq "$(findstring :,$(_cachedir))" ""
+  RNMAKE_CACHE_DIR := $(_cachedir)
+else ifdef _cachedir
+  RNMAKE_CACHE_DIR := $(abspath $(_cachedir))
+endif
+
+undefine _cachedir
+
+# ------------------------------------------------------------------------------
+# RNMAKE_MEMGATE
+#   Memory gated compiles. When enabled, each compile waits until enough
+#   memory is free for its expected peak memory (see utils/memgate.sh).
+#
+#   Make override:    make memgate=<y|n> ...
+#   Fallback default: n
+# ------------------------------------------------------------------------------
+
+# 'make memgate=<y|n> ...' or RNMAKE_MEMGATE
+memgate ?= $(RNMAKE_MEMGATE)
+
+ifneq "$(filter y yes 1,$(memgate))" ""
+  RNMAKE_MEMGATE := y
+else
+  undefine RNMAKE_MEMGATE
+endif
+
+# ------------------------------------------------------------------------------
+# RNMAKE_MARCH_LEVELS
+#   Microarchitecture levels (e.g. x86-64-v3) built in addition to the baseline
+#   architecture. Levels not supported by the target architecture are ignored.
+#
+#   Make override:    make march=<level[,level...]> ...
+#   Fallback default: none
+# ------------------------------------------------------------------------------
+
+# 'make march=<level[,level...]> ...' or RNMAKE_MARCH_LEVELS
+march ?= $(RNMAKE_MARCH_LEVELS)
+
+_comma := ,
+
+ifneq "$(strip $(march))" ""
+  RNMAKE_MARCH_LEVELS := $(sort $(subst $(_comma), ,$(march)))
+else
+  undefine RNMAKE_MARCH_LEVELS
+endif
+
+undefine _comma
+
+# ------------------------------------------------------------------------------
+# RNMAKE_ONLY
+#   Targets made by 'make all' at the package root, together with their LIBDEPS
+#   library dependencies. No other directory is visited.
+#
+#   Make override:    make only=<target[,target...]> ...
+#   Fallback default: (all targets)
+# ------------------------------------------------------------------------------
+
+_comma := ,
+
+ifneq "$(strip $(only))" ""
+  RNMAKE_ONLY := $(sort $(subst $(_comma), ,$(only)))
+else
+  undefine RNMAKE_ONLY
+endif
+
+undefine _comma
+
 # ------------------------------------------------------------------------------
 # Export to sub-makes
 #
 export RNMAKE_ARCH_TAG
 export RNMAKE_INSTALL_XPREFIX
 export RNMAKE_INSTALL_PREFIX
+export RNMAKE_CACHE_DIR
+export RNMAKE_MEMGATE
+export RNMAKE_MARCH_LEVELS
+export RNMAKE_ONLY
 
 ifdef RNMAKE_DOXY
 /*! \endcond RNMAKE_DOXY */
@@ -72,11 +72,27 @@ Specific rnmake variables:\n\
   arch=TAG       Specify rnmake Arch/Arch.TAG.mk architecture make file.\n\
                  Overrides environment variable RNMAKE_ARCH_DFT.\n\
                    fallback default: x86_64\n\
+  cachedir=DIR   Prebuilt distribution cache directory ([user@]host:path\n\
+                 for rsync). Overrides environment variable\n\
+                 RNMAKE_CACHE_DIR. 'off' disables.\n\
+                   fallback default: (disabled)\n\
   color=SCHEME   Set color scheme. One of:\n\
                    rnmake(default) neon brazil whites off(no color)\n\
   xprefix=PATH   Cross-install directory path prefix. Overrides environment\n\
                  variable RNMAKE_INSTALL_XPREFIX.\n\
                    fallback default: \$$(HOME)/xinstall\n\
+  march=LEVELS   Also make libraries for the comma separated microarch\n\
+                 levels (e.g. x86-64-v3,x86-64-v4). Overrides environment\n\
+                 variable RNMAKE_MARCH_LEVELS.\n\
+                   fallback default: (none)\n\
+  memgate=y      Admit each compile only when enough memory is free for its\n\
+                 expected peak memory (TGT.COMPILE_MEM, SRC.COMPILE_MEM,\n\
+                 or learned). Overrides environment variable RNMAKE_MEMGATE.\n\
+                   fallback default: n\n\
+  only=TARGETS   At the package root, make only the comma separated library\n\
+                 and program targets and their library dependencies.\n\
+                 'make TARGET' is equivalent to 'make only=TARGET'.\n\
+                   fallback default: (all targets)\n\
   prefix=PATH    Install directory path prefix. Overrides environment\n\
                  variable RNMAKE_INSTALL_PREFIX.\n\
                    fallback default: \$$(RNMAKE_INSTALL_XPREFIX)"
@@ -91,7 +107,9 @@ help-env:
 Environment Variables\n\
 RNMAKE_ARCH_DFT          Default rnmake architecture tag.\n\
 RNMAKE_INSTALL_XPREFIX   Cross-install directory path.\n\
-RNMAKE_INSTALL_PREFIX    Install directory path."
+RNMAKE_INSTALL_PREFIX    Install directory path.\n\
+RNMAKE_CACHE_DIR         Prebuilt distribution cache directory.\n\
+RNMAKE_MEMGATE           Memory gated compiles (y or n)."
 
 help-arch:
 	$(printCurGoal)
@@ -143,17 +161,24 @@ Debian Package Specific Targets\n\
 dpkgs     - makes all debian packages for an architecture\n\
 dpkg-dev  - makes debian development package\n\
 dpkg-doc  - makes debian documentation package\n\
-dpkg-src  - makes debian source package"
+dpkg-src  - makes debian source package\n\
+\n\
+Use make -j dpkgs to make the packages concurrently. DEB_COMPRESS selects the\n\
+package compression (xz zstd gzip none), DEB_THREADS the compressor threads."
 
 help-other:
 	$(printCurGoal)
 	@echo "\
 Focused Targets\n\
-LIB         - makes library LIB in current directory\n\
-PGM         - makes program PGM in current directory\n\
-SRC.e       - makes post CPP processed source from SRC.{c|cxx|cpp}\n\
-SRC.o       - makes object from SRC.{c|cxx|cpp}\n\
-SUBDIR.all  - makes subdirectory SUBDIR of current directory"
+cache-query  - prints package build key and cache hit or miss (cachedir=DIR)\n\
+LIB          - makes library LIB in current directory\n\
+PGM          - makes program PGM in current directory\n\
+SRC.e        - makes post CPP processed source from SRC.{c|cxx|cpp}\n\
+SRC.o        - makes object from SRC.{c|cxx|cpp}\n\
+size-report  - reports sizes, largest symbols, and template bloat of targets\n\
+size-compare - size-report and fails on growth (base=JSON [threshold=PCT])\n\
+SUBDIR.all   - makes subdirectory SUBDIR of current directory\n\
+watch        - continuously rebuilds on source changes (Ctrl-C to stop)"
 
 help-help:
 	$(printCurGoal)
@@ -0,0 +1,123 @@
+################################################################################
+#
+# Rules.cache.mk
+#
+ifdef RNMAKE_DOXY
+/*! 
+\file 
+
+\brief Prebuilt distribution tree cache.
+
+This file is automatically included by \ref Rules.mk at the package root when
+the cache directory RNMAKE_CACHE_DIR is defined (make cachedir=DIR).
+
+A package build key is computed from the content of the package source files,
+the package and architecture makefiles, the build profile, and the keys of any
+dependency packages listed in RNMAKE_PKG_DEPS. After a successful 'all', the
+distribution tree \$(DIST_ARCH) is stored in the cache under that key. When the
+key is already cached, 'all' restores the tree instead of building it.
+
+\pkgsynopsis
+RN Make System
+
+\pkgfile{Rules.cache.mk}
+
+\pkgauthor{Robin Knight,robin.knight@roadnarrows.com}
+
+\pkgcopyright{2020,RoadNarrows LLC,http://www.roadnarrows.com}
+
+\LegalBegin
+Copyright (c) 2005-2020 RoadNarrows LLC
+
+Licensed under the MIT License (the "License").
+
+You may not use this file except in compliance with the License. You may
+obtain a copy of the License at:
+
+https://opensource.org/licenses/MIT
+
+The software is provided "AS IS", without warranty of any kind, express or
+implied, including but not limited to the warranties of merchantability,
+fitness for a particular purpose and noninfringement. in no event shall the
+authors or copyright holders be liable for any claim, damages or other
+liability, whether in an action of contract, tort or otherwise, arising from,
+out of or in connection with the software or the use or other dealings in the
+software.
+\LegalEnd
+
+\cond RNMAKE_DOXY
+ */
+endif
+#
+################################################################################
+
+#$(info DBG: $(lastword $(MAKEFILE_LIST)))
+
+export _RULES_CACHE_MK = 1
+
+DISTCACHE = $(RNMAKE_ROOT)/utils/distcache.sh
+
+# cache entry name
+CACHE_NAME = $(RNMAKE_PKG)/$(RNMAKE_ARCH)
+
+# package build key file recorded in the distribution
+CACHE_KEY_FILE = $(DIST_ARCH)/cache.key
+
+# build key files of dependency packages
+# (relative package paths are relative to the workspace of this package)
+CACHE_DEP_KEY_FILES = $(foreach pkg,$(RNMAKE_PKG_DEPS),\
+	$(if $(filter /%,$(pkg)),$(pkg),$(dir $(RNMAKE_PKG_ROOT))$(pkg))$(strip \
+	)/dist/dist.$(RNMAKE_ARCH)/cache.key)
+
+# build profile
+CACHE_PROFILE = $(RNMAKE_ARCH_TAG) $(CC) $(CXX) \
+								$(CPPFLAGS) $(CFLAGS) $(CXXFLAGS) $(LDFLAGS) $(LD_LIBS) \
+								$(MARCH_LEVELS)
+
+# package build key
+RNMAKE_CACHE_KEY := $(shell $(DISTCACHE) key \
+	--root=$(RNMAKE_PKG_ROOT) \
+	--profile='$(strip $(CACHE_PROFILE))' \
+	$(addprefix --exclude=,$(AUTOHDRS)) \
+	$(addprefix --dep-key=,$(CACHE_DEP_KEY_FILES)) \
+	$(RNMAKE_PKG_MKFILE) \
+	$(wildcard $(RNMAKE_PKG_ROOT)/pkgcfg/env.mk) \
+	$(RNMAKE_ARCH_MKFILE))
+
+ifeq ($(RNMAKE_CACHE_KEY),)
+  $(error Cannot compute package build key for cache $(RNMAKE_CACHE_DIR))
+endif
+
+CACHE_OPTS = --cache-dir=$(RNMAKE_CACHE_DIR) \
+						 --name=$(CACHE_NAME) \
+						 --key=$(RNMAKE_CACHE_KEY) \
+						 --dist=$(DIST_ARCH)
+
+# cached archive, if any
+RNMAKE_CACHE_HIT := $(shell $(DISTCACHE) lookup $(CACHE_OPTS))
+
+# Restore distribution tree from cache.
+.PHONY: cache-restore
+cache-restore:
+	$(call printGoalWithDesc,$(@),\
+		Restoring distribution from $(RNMAKE_CACHE_DIR))
+	@$(DISTCACHE) restore $(CACHE_OPTS)
+	@echo "$(RNMAKE_CACHE_KEY)" > $(CACHE_KEY_FILE)
+
+# Store distribution tree into cache.
+# (only after the build prerequisites of 'all' have been made, even with -j,
+# so a failed build is never stored)
+.PHONY: cache-store
+cache-store: $(EXTRA_TGT_ALL) pkg subdirs-all $(EXTRA_TGT_ALL_POST)
+	$(call printGoalWithDesc,$(@),Storing distribution in $(RNMAKE_CACHE_DIR))
+	@echo "$(RNMAKE_CACHE_KEY)" > $(CACHE_KEY_FILE)
+	@$(DISTCACHE) store $(CACHE_OPTS)
+
+# Print cache status of package build key.
+.PHONY: cache-query
+cache-query:
+	@echo "$(RNMAKE_CACHE_KEY) $(if $(RNMAKE_CACHE_HIT),hit,miss)"
+
+ifdef RNMAKE_DOXY
+/*! \endcond RNMAKE_DOXY */
+endif
@@ -201,6 +201,7 @@ docs-final: echo-docs-final
 	@if [ -f "$(RNMAKE_PKG_HOME_INDEX)" ]; \
 	then \
 		$(PYTHON) $(RNMAKE_ROOT)/utils/homepagemk.py \
+			--cache="$(DISTDIR_TMP)/homepage.hash" \
 			--rel-files="$(addsuffix ;,$(REL_FILES))" \
 			--doxy-index="$(DOXY_HTML_OUTPUT)/index.html" \
 			$(nocolor_opt) \
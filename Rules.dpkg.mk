@@ -11,6 +11,13 @@ ifdef RNMAKE_DOXY
 This file is automatically included by \ref Rules.mk when one or more of the
 Debian make goals are specified.
 
+Each package is assembled by its own make recipe, so 'make -j dpkgs' builds
+the development, source, and documentation packages concurrently. Package
+trees are staged with hardlinks into the distribution and compressed with
+multi-threaded xz (or DEB_COMPRESS; zstd is faster but needs dpkg 1.21.18 or
+later on the installing host). File timestamps are clamped to
+DEB_SOURCE_DATE_EPOCH so unchanged inputs reproduce byte-identical packages.
+
 \pkgsynopsis
 RN Make System
 
@@ -82,7 +89,42 @@ ifndef _RULES_DOC_MK
   $(eval include $(RNMAKE_ROOT)/Rules.doc.mk)
 endif
 
-dpkgs: pkg-banner dpkgs-echo dpkg-dev dpkg-src dpkg-doc
+# Debian package compression type (xz, zstd, gzip, or none) and level. The
+# default xz installs with any dpkg; older dpkg (< 1.21.18, e.g. on embedded
+# targets) cannot install zstd packages.
+DEB_COMPRESS        ?= xz
+DEB_COMPRESS_LEVEL  ?=
+
+# maximum number of compressor threads per package
+DEB_THREADS         ?= $(shell nproc 2>/dev/null || echo 1)
+
+# packaged files timestamp (default: time of the last package commit)
+ifndef DEB_SOURCE_DATE_EPOCH
+  DEB_SOURCE_DATE_EPOCH := $(or $(SOURCE_DATE_EPOCH),$(shell \
+	  git -C $(RNMAKE_PKG_ROOT) log -1 --format=%ct 2>/dev/null || echo 0))
+endif
+
+# $(call dpkgBuild,confdir,tmpdir,name,pkgtype)
+# 	Assemble debian package from distribution.
+define dpkgBuild
+	$(if $(call isDir,$(1)),\
+		@$(RNMAKE_ROOT)/utils/dpkg-helper.sh \
+			-a $(RNMAKE_ARCH) \
+			-c $(1) \
+			-d $(DIST_ARCH) \
+			-t $(2) \
+			-n $(3) \
+			-p $(RNMAKE_DEB_PREFIX) \
+			-v $(RNMAKE_PKG_VERSION_DOTTED) \
+			-y $(4) \
+			-Z $(DEB_COMPRESS) \
+			$(if $(DEB_COMPRESS_LEVEL),-z $(DEB_COMPRESS_LEVEL)) \
+			-j $(DEB_THREADS) \
+			-s $(DEB_SOURCE_DATE_EPOCH),\
+		$(call printInfo,$(1): $(MSG_SKIP)))
+endef
+
+dpkgs: pkg-banner dpkgs-echo dpkg-dev-deb dpkg-src-deb dpkg-doc-deb
 	$(footer)
 
 .PHONY: dpkgs-echo
@@ -90,56 +132,29 @@ dpkgs-echo:
 	$(call printGoalWithDesc,$(@),Make all debian packages)
 
 .PHONY: dpkg-dev
-dpkg-dev: pkg-banner all echo-dpkg-dev
-	$(if $(call isDir, $(DEB_CONF_DEV)),\
-		$(shell $(RNMAKE_ROOT)/utils/dpkg-helper.sh \
-			-a $(RNMAKE_ARCH) \
-			-c $(DEB_CONF_DEV) \
-			-d $(DIST_ARCH) \
-			-t $(DISTDIR_TMP_DEB_DEV) \
-			-n $(DEB_PKG_DEV_NAME) \
-			-p $(RNMAKE_DEB_PREFIX) \
-			-v $(RNMAKE_PKG_VERSION_DOTTED) \
-			-y pkgtype-dev \
-			1>&2 \
-	 	),\
-		$(call printInfo,$(DEB_CONF_DEV): $(MSG_SKIP)))
+dpkg-dev: pkg-banner echo-dpkg-dev dpkg-dev-deb
 	$(footer)
+
+.PHONY: dpkg-dev-deb
+dpkg-dev-deb: all
+	$(call dpkgBuild,$(DEB_CONF_DEV),$(DISTDIR_TMP_DEB_DEV),$(DEB_PKG_DEV_NAME),pkgtype-dev)
 	
 .PHONY: dpkg-src
-dpkg-src: pkg-banner echo-dpkg-src copy-src
-	$(if $(call isDir, $(DEB_CONF_SRC)),\
-		$(shell $(RNMAKE_ROOT)/utils/dpkg-helper.sh \
-			-a $(RNMAKE_ARCH) \
-			-c $(DEB_CONF_SRC) \
-			-d $(DIST_ARCH) \
-			-t $(DISTDIR_TMP_DEB_SRC) \
-			-n $(DEB_PKG_SRC_NAME) \
-			-p $(RNMAKE_DEB_PREFIX) \
-			-v $(RNMAKE_PKG_VERSION_DOTTED) \
-			-y pkgtype-src \
-			1>&2 \
-	 	),\
-		$(call printInfo $(DEB_CONF_SRC): $(MSG_SKIP)))
+dpkg-src: pkg-banner echo-dpkg-src dpkg-src-deb
 	$(footer)
 
+.PHONY: dpkg-src-deb
+dpkg-src-deb: copy-src
+	$(call dpkgBuild,$(DEB_CONF_SRC),$(DISTDIR_TMP_DEB_SRC),$(DEB_PKG_SRC_NAME),pkgtype-src)
+
 .PHONY: dpkg-doc
-dpkg-doc: pkg-banner documents echo-dpkg-doc
-	$(if $(call isDir, $(DEB_CONF_DOC)),\
-		$(shell $(RNMAKE_ROOT)/utils/dpkg-helper.sh \
-			-a $(RNMAKE_ARCH) \
-			-c $(DEB_CONF_DOC) \
-			-d $(DIST_ARCH) \
-			-t $(DISTDIR_TMP_DEB_DOC) \
-			-n $(DEB_PKG_DOC_NAME) \
-			-p $(RNMAKE_DEB_PREFIX) \
-			-v $(RNMAKE_PKG_VERSION_DOTTED) \
-			-y pkgtype-doc \
-			1>&2 \
-	 	),\
-		$(call printInfo $(DEB_CONF_DOC): $(MSG_SKIP)))
+dpkg-doc: pkg-banner echo-dpkg-doc dpkg-doc-deb
 	$(footer)
 
+.PHONY: dpkg-doc-deb
+dpkg-doc-deb: documents
+	$(call dpkgBuild,$(DEB_CONF_DOC),$(DISTDIR_TMP_DEB_DOC),$(DEB_PKG_DOC_NAME),pkgtype-doc)
+
 
 ifdef RNMAKE_DOXY
 /*! \endcond RNMAKE_DOXY */
@@ -0,0 +1,110 @@
+################################################################################
+#
+# Rules.include.mk
+#
+ifdef RNMAKE_DOXY
+/*! 
+\file 
+
+\brief Include graph report of package headers.
+
+This file is automatically included by \ref Rules.mk when one or more of the
+include make goals are specified.
+
+The 'include-report' goal ranks the package headers included by the sources
+of the current directory and its subdirectories by rebuild cost: the summed
+compile cost of all translation units that include the header, directly or
+transitively. The compile cost of a translation unit is the total size of its
+source and included headers. The report also flags heavy system includes
+(e.g. <regex>, <iostream>) of package headers, and system includes a package
+header already reaches through another included package header. A JSON copy of
+the report is written to $(DISTDIR_TMP)/include-report.json.
+
+The report is made from the header dependency files of 'make deps'.
+
+\code
+make deps
+make include-report [heavy=<KB>]
+\endcode
+
+\pkgsynopsis
+RN Make System
+
+\pkgfile{Rules.include.mk}
+
+\pkgauthor{Robin Knight,robin.knight@roadnarrows.com}
+
+\pkgcopyright{2020,RoadNarrows LLC,http://www.roadnarrows.com}
+
+\LegalBegin
+Copyright (c) 2005-2020 RoadNarrows LLC
+
+Licensed under the MIT License (the "License").
+
+You may not use this file except in compliance with the License. You may
+obtain a copy of the License at:
+
+https://opensource.org/licenses/MIT
+
+The software is provided "AS IS", without warranty of any kind, express or
+implied, including but not limited to the warranties of merchantability,
+fitness for a particular purpose and noninfringement. in no event shall the
+authors or copyright holders be liable for any claim, damages or other
+liability, whether in an action of contract, tort or otherwise, arising from,
+out of or in connection with the software or the use or other dealings in the
+software.
+\LegalEnd
+
+\cond RNMAKE_DOXY
+ */
+endif
+#
+################################################################################
+
+#$(info DBG: $(lastword $(MAKEFILE_LIST)))
+
+export _RULES_INCLUDE_MK = 1
+
+GOALS_WITH_SUBDIRS += include-depfiles
+
+# list of dependency files to analyze
+INCLUDE_DEPFILES_FILE = $(DISTDIR_TMP)/include.depfiles
+
+# JSON report
+INCLUDE_REPORT = $(DISTDIR_TMP)/include-report.json
+
+# 'make include-report heavy=<KB>'
+INCLUDE_HEAVY ?= $(if $(heavy),$(heavy),256)
+
+# number of entries reported per section
+INCLUDE_TOP ?= 20
+
+# List dependency files of current directory and subdirectories.
+.PHONY: include-depfiles
+include-depfiles: include-depfiles-here subdirs-include-depfiles
+
+.PHONY: include-depfiles-here
+include-depfiles-here:
+	@test -d $(DISTDIR_TMP) || $(MKDIR) $(DISTDIR_TMP)
+	$(foreach f,$(wildcard $(DEPSFILE)),\
+		$(file >>$(INCLUDE_DEPFILES_FILE),$(abspath $(f))))
+
+# Report package headers by rebuild cost and heavy system includes.
+.PHONY: include-report
+include-report: pkg-banner
+	$(call printGoalWithDesc,$(@),Include graph report)
+	@$(RM) $(INCLUDE_DEPFILES_FILE)
+	@$(MAKE) -s --no-print-directory include-depfiles
+	@$(PYTHON) $(RNMAKE_ROOT)/utils/includemk.py \
+		$(if $(call eq,$(color),off),--no-color) \
+		--cxx="$(CXX) $(CXXFLAGS_STD)" \
+		--heavy=$(INCLUDE_HEAVY) \
+		--top=$(INCLUDE_TOP) \
+		--root=$(RNMAKE_PKG_ROOT) \
+		--output=$(INCLUDE_REPORT) \
+		$(INCLUDE_DEPFILES_FILE)
+	$(footer)
+
+ifdef RNMAKE_DOXY
+/*! \endcond RNMAKE_DOXY */
+endif
@@ -151,6 +151,30 @@ $(call includeIfGoals,help help-%,$(RNMAKE_ROOT)/Help.mk)
 
 $(call includeIfGoals,test run-test,$(RNMAKE_ROOT)/Rules.test.mk)
 
+#------------------------------------------------------------------------------
+# Continuous rebuild from a flattened build graph (Rules.watch.mk)
+#
+# Check if any of the make goals contain watch goals. If true, include the
+# watch makefile, which defines the watch and watch-graph rules.
+
+$(call includeIfGoals,watch watch-%,$(RNMAKE_ROOT)/Rules.watch.mk)
+
+#------------------------------------------------------------------------------
+# Binary size and symbol bloat reports (Rules.size.mk)
+#
+# Check if any of the make goals contain size goals. If true, include the
+# size makefile, which defines the size-report and size-compare rules.
+
+$(call includeIfGoals,size-%,$(RNMAKE_ROOT)/Rules.size.mk)
+
+#------------------------------------------------------------------------------
+# Include graph report (Rules.include.mk)
+#
+# Check if any of the make goals contain include goals. If true, include the
+# include makefile, which defines the include-report rule.
+
+$(call includeIfGoals,include-%,$(RNMAKE_ROOT)/Rules.include.mk)
+
 # -------------------------------------------------------------------------
 # Architecture Dependent Definitions
 
@@ -534,6 +558,19 @@ AUTOHDRS = $(AUTO_VERSION_H)
 # DEPRECATED AUTO_INSTALL_H = $(AUTO_INCDIR)/install-$(RNMAKE_ARCH).h
 # DEPRECATED AUTOHDRS += $(AUTO_INSTALL_H)
 
+# Generated Source Headers
+#
+# Headers generated in the current directory from source files by a generator
+# command, such as constant tables compiled from a definition file:
+# 	RNMAKE_GEN_HDRS 		list of generated headers in the current directory
+# 	<hdr>.SRC 					generator input files (e.g. troglodese_lang.h.SRC)
+# 	<hdr>.GEN 					generator command, run as '<hdr>.GEN <hdr>.SRC' writing
+# 											the header to stdout
+# Generated headers are made with the auto-generated headers, so they exist
+# before 'make deps' scans the sources. A header is regenerated when its input
+# files or the generator's local files change, and is replaced only when its
+# content changes.
+
 #------------------------------------------------------------------------------
 # Target Specific Variables
 
@@ -543,6 +580,109 @@ $(FQ_SHLIBS): CFLAGS += $(SHLIB_CFLAGS)
 # Dynamically Linked library compiled objects need special CFLAGS
 $(FQ_DLLIBS): CFLAGS += $(DLLIB_CFLAGS)
 
+#------------------------------------------------------------------------------
+# Memory Gated Compiles
+#
+# If RNMAKE_MEMGATE is enabled (make memgate=y), each object compile is wrapped
+# by utils/memgate.sh which only admits the compile when enough memory is free.
+# Running gated compiles hold only the part of their expected peak memory they
+# have not used yet.
+# The expected peak memory (MB) of a compile is, in order of precedence:
+# 	<src>.COMPILE_MEM   		source specific hint (e.g. clan.cxx.COMPILE_MEM)
+# 	<tgt>.COMPILE_MEM  			target specific hint for all target objects
+# 	learned 								peak memory measured by the last compile
+# 	RNMAKE_MEMGATE_DFT 			default (0 admits immediately)
+# Learned values are kept in $(MEMGATE_DIR) which survives clean and clobber.
+
+RNMAKE_MEMGATE_DFT ?= 0
+
+MEMGATE_DIR = $(DEPSDIR)/mem.$(RNMAKE_ARCH)
+
+# $(call compileMem,src)
+# 	Expected peak memory hint of source compile, if any.
+compileMem = $(or $($(1).COMPILE_MEM),$(COMPILE_MEM))
+
+# $(call compileGate,src,obj)
+# 	Compile command prefix.
+ifdef RNMAKE_MEMGATE
+compileGate = $(RNMAKE_ROOT)/utils/memgate.sh \
+	$(if $(call compileMem,$(1)),--mem=$(call compileMem,$(1))) \
+	--default=$(RNMAKE_MEMGATE_DFT) \
+	--record=$(MEMGATE_DIR)/$(notdir $(2)).mem --
+else
+compileGate =
+endif
+
+#------------------------------------------------------------------------------
+# Microarchitecture Levels
+#
+# If RNMAKE_MARCH_LEVELS is set (make march=<level[,level...]>), each library
+# is also made for every level supported by the architecture (see
+# RNMAKE_ARCH_MARCH_LEVELS and march_flags in the Arch.<arch>.mk files). Level
+# objects are compiled in $(OBJDIR)/<level>. Level libraries are made in:
+# 	<libdir>/glibc-hwcaps/<level>/	shared and dynamically linked libraries
+# 	<libdir>/<level>/								distribution static libraries
+# The dynamic loader picks the best shared library variant supported by the
+# host at load time. Static library consumers link a level explicitly with
+# -L<libdir>/<level>.
+
+MARCH_LEVELS = $(filter $(RNMAKE_ARCH_MARCH_LEVELS),$(RNMAKE_MARCH_LEVELS))
+
+ifneq "$(filter-out $(RNMAKE_ARCH_MARCH_LEVELS),$(RNMAKE_MARCH_LEVELS))" ""
+  $(warning Ignoring microarchitecture levels not supported by $(RNMAKE_ARCH):\
+    $(filter-out $(RNMAKE_ARCH_MARCH_LEVELS),$(RNMAKE_MARCH_LEVELS)))
+endif
+
+# $(call march_objs,objs,level)
+# 	Level objects of baseline objects.
+march_objs = $(patsubst $(OBJDIR)/%,$(OBJDIR)/$(2)/%,$(1))
+
+# $(call march_hwcaps_libs,fqlib)
+# 	Fully qualified glibc-hwcaps level libraries of baseline library.
+march_hwcaps_libs = $(foreach lvl,$(MARCH_LEVELS),\
+	$(dir $(1))glibc-hwcaps/$(lvl)/$(notdir $(1)))
+
+# $(call march_lib_level,fqlib)
+# 	Level of fully qualified level library.
+march_lib_level = $(filter $(MARCH_LEVELS),$(subst /, ,$(1)))
+
+#------------------------------------------------------------------------------
+# Prebuilt distribution cache (Rules.cache.mk)
+#
+# If a cache directory is defined, include the cache makefile at the top-level
+# package root for goals that make the distribution. The makefile computes the
+# package build key and defines RNMAKE_CACHE_HIT if the key is cached.
+
+ifdef RNMAKE_CACHE_DIR
+ifdef RNMAKE_TOP_MAKEFILE
+ifdef MAKE_TOP_LEVEL
+$(call includeIfGoals,all install cache-%,$(RNMAKE_ROOT)/Rules.cache.mk)
+endif
+endif
+endif
+
+#------------------------------------------------------------------------------
+# Target-scoped builds (Rules.only.mk)
+#
+# At the package root, 'make only=TARGET[,TARGET...]' makes just the targets
+# and their library dependencies. The only-index goal makes the package target
+# index in the current directory and its subdirectories.
+
+ifneq "$(and $(RNMAKE_TOP_MAKEFILE),$(RNMAKE_ONLY))" ""
+include $(RNMAKE_ROOT)/Rules.only.mk
+else
+$(call includeIfGoals,only-%,$(RNMAKE_ROOT)/Rules.only.mk)
+endif
+
+# At the package root, a command-line goal without a rule is made as a
+# target-scoped build of the target of that name ('make clan' is equivalent to
+# 'make only=clan').
+ifdef RNMAKE_TOP_MAKEFILE
+.DEFAULT:
+	$(if $(filter $(@),$(MAKECMDGOALS)),\
+		@RNMAKE_ONLY=$(@) $(MAKE) --no-print-directory)
+endif
+
 #------------------------------------------------------------------------------
 # Common Support Functions and Macros
 
@@ -568,9 +708,15 @@ mkobjdir = @test -d "$(OBJDIR)" || $(MKDIR) "$(OBJDIR)"
 ALL_DONE_MARK = $(DIST_ARCH)/all.done
 
 .PHONY: all
-ifdef MAKE_TOP_LEVEL 
+ifdef RNMAKE_ONLY_BUILD
+all: pkg-banner only-build
+	$(footer)
+else ifdef RNMAKE_CACHE_HIT
+all: pkg-banner once-for-all cache-restore all-done
+	$(footer)
+else ifdef MAKE_TOP_LEVEL 
 all: pkg-banner check-deps once-for-all $(EXTRA_TGT_ALL) pkg subdirs-all \
-			$(EXTRA_TGT_ALL_POST) all-done
+			$(EXTRA_TGT_ALL_POST) all-done $(if $(_RULES_CACHE_MK),cache-store)
 	$(footer)
 else
 all: check-deps $(EXTRA_TGT_ALL) pkg subdirs-all $(EXTRA_TGT_ALL_POST)
@@ -634,6 +780,7 @@ $(RNMAKE_LOC_STLIBS): $(call fq_stlib_names,$(LOCDIR_LIB),$(GOAL_LIST))
 define STLIBtemplate
  $(1).OBJS  = $(call objs_from_src,$(1))
  $(1).FQ_LIB = $(call fq_stlib_names,$(2),$(1))
+ $(if $($(1).COMPILE_MEM),$$($(1).OBJS): COMPILE_MEM = $($(1).COMPILE_MEM))
  OUTDIR = $$(dir $$($(1).FQ_LIB))
  $$($(1).FQ_LIB): $$($(1).OBJS)
 	@printf "\n"
@@ -641,6 +788,20 @@ define STLIBtemplate
 	@test -d "$$(OUTDIR)" || $(MKDIR) $$(OUTDIR)
 	$$(STLIB_LD) $$(STLIB_LD_FLAGS) $$(STLIB_LD_EXTRAS) $$@  $$($(1).OBJS)
 	$$(RANLIB) $$@
+ ifneq "$$(and $$(MARCH_LEVELS),$$(filter $(DISTDIR_LIB),$(2)))" ""
+ $(1).FQ_LIB_MARCH = $$(foreach lvl,$$(MARCH_LEVELS),\
+		$$(dir $$($(1).FQ_LIB))$$(lvl)/$$(notdir $$($(1).FQ_LIB)))
+ $$($(1).FQ_LIB): | $$($(1).FQ_LIB_MARCH)
+ $$(foreach lvl,$$(MARCH_LEVELS),$$(eval \
+		$$(dir $$($(1).FQ_LIB))$$(lvl)/$$(notdir $$($(1).FQ_LIB)): \
+			$$(call march_objs,$$($(1).OBJS),$$(lvl))))
+ $$($(1).FQ_LIB_MARCH):
+	@printf "\n"
+	@printf "$(color_tgt_lib)     $$@$(color_end)\n"
+	@test -d "$$(@D)" || $(MKDIR) $$(@D)
+	$$(STLIB_LD) $$(STLIB_LD_FLAGS) $$(STLIB_LD_EXTRAS) $$@  $$^
+	$$(RANLIB) $$@
+ endif
 endef
 
 # Template to build a shared library including all necessary prerequisites
@@ -648,12 +809,25 @@ define SHLIBtemplate
  $(1).OBJS  = $(call objs_from_src,$(1))
  $(1).LIBS := $(addprefix -l, $($(1).LIBS))
  $(1).FQ_LIB = $(call fq_shlib_names,$(2),$(1))
+ $(if $($(1).COMPILE_MEM),$$($(1).OBJS): COMPILE_MEM = $($(1).COMPILE_MEM))
  OUTDIR = $$(dir $$($(1).FQ_LIB))
  $$($(1).FQ_LIB): $$($(1).OBJS)
 	@printf "\n"
 	@printf "$(color_tgt_lib)     $$@$(color_end)\n"
 	@test -d "$$(OUTDIR)" || $(MKDIR) $$(OUTDIR)
 	$$(SHLIB_LD) $$(SHLIB_LD_FLAGS) $$(SHLIB_LD_EXTRAS) -o $$@  $$($(1).OBJS) $$(LD_LIBPATHS) $$($(1).LIBS) $$(LD_LIBS)
+ ifneq "$$(MARCH_LEVELS)" ""
+ $(1).FQ_LIB_MARCH = $$(call march_hwcaps_libs,$$($(1).FQ_LIB))
+ $$($(1).FQ_LIB): | $$($(1).FQ_LIB_MARCH)
+ $$(foreach lib,$$($(1).FQ_LIB_MARCH),$$(eval \
+		$$(lib): $$(call march_objs,$$($(1).OBJS),$$(call march_lib_level,$$(lib)))))
+ $$($(1).FQ_LIB_MARCH): CFLAGS += $$(SHLIB_CFLAGS)
+ $$($(1).FQ_LIB_MARCH):
+	@printf "\n"
+	@printf "$(color_tgt_lib)     $$@$(color_end)\n"
+	@test -d "$$(@D)" || $(MKDIR) $$(@D)
+	$$(SHLIB_LD) $$(SHLIB_LD_FLAGS) $$(SHLIB_LD_EXTRAS) -o $$@  $$^ $$(LD_LIBPATHS) $$($(1).LIBS) $$(LD_LIBS)
+ endif
 endef
 
 # Template to build a dynamically linke library including all necessary
@@ -662,12 +836,25 @@ define DLLIBtemplate
  $(1).OBJS  = $(call objs_from_src,$(1))
  $(1).LIBS := $(addprefix -l, $($(1).LIBS))
  $(1).FQ_LIB = $(call fq_dllib_names,$(2),$(1))
+ $(if $($(1).COMPILE_MEM),$$($(1).OBJS): COMPILE_MEM = $($(1).COMPILE_MEM))
  OUTDIR = $$(dir $$($(1).FQ_LIB))
  $$($(1).FQ_LIB): $$($(1).OBJS)
 	@printf "\n"
 	@printf "$(color_tgt_lib)     $$@$(color_end)\n"
 	@test -d "$$(OUTDIR)" || $(MKDIR) $$(OUTDIR)
 	$$(DLLIB_LD) $$(DLLIB_LD_FLAGS) $$(DLLIB_LD_EXTRAS) $$($(1).OBJS) $$(LD_LIBPATHS) $$($(1).LIBS) $$(LD_LIBS) -o $$@
+ ifneq "$$(MARCH_LEVELS)" ""
+ $(1).FQ_LIB_MARCH = $$(call march_hwcaps_libs,$$($(1).FQ_LIB))
+ $$($(1).FQ_LIB): | $$($(1).FQ_LIB_MARCH)
+ $$(foreach lib,$$($(1).FQ_LIB_MARCH),$$(eval \
+		$$(lib): $$(call march_objs,$$($(1).OBJS),$$(call march_lib_level,$$(lib)))))
+ $$($(1).FQ_LIB_MARCH): CFLAGS += $$(DLLIB_CFLAGS)
+ $$($(1).FQ_LIB_MARCH):
+	@printf "\n"
+	@printf "$(color_tgt_lib)     $$@$(color_end)\n"
+	@test -d "$$(@D)" || $(MKDIR) $$(@D)
+	$$(DLLIB_LD) $$(DLLIB_LD_FLAGS) $$(DLLIB_LD_EXTRAS) $$^ $$(LD_LIBPATHS) $$($(1).LIBS) $$(LD_LIBS) -o $$@
+ endif
 endef
 
 # For each library target, evaluate (i.e make) the template.
@@ -702,9 +889,11 @@ $(RNMAKE_DIST_PGMS): $(call fq_pgm_names,$(DISTDIR_BIN),$(GOAL_LIST))
 # Template to build a program including all necessary prerequisites
 define PGMtemplate
  $(1).OBJS  = $(call objs_from_src,$(1))
- $(1).LIBDEPS  = $(shell $(RNMAKE_ROOT)/utils/libdeps.sh $(LIBS_VPATH) $($(1).LIBDEPS))
+ $(1).LIBDEPS_NAMES = $($(1).LIBDEPS)
+ $(1).LIBDEPS  = $(call findLibDeps,$(LIBS_VPATH),$($(1).LIBDEPS))
  $(1).LIBS := $(addprefix -l, $($(1).LIBS))
  $(1).FQ_PGM = $(call fq_pgm_names,$(2),$(1))
+ $(if $($(1).COMPILE_MEM),$$($(1).OBJS): COMPILE_MEM = $($(1).COMPILE_MEM))
  $$($(1).FQ_PGM): $$($(1).OBJS) $$($(1).LIBDEPS)
 	@printf "\n"
 	@printf "$(color_tgt_pgm)     $$@$(color_end)\n"
@@ -724,7 +913,7 @@ $(foreach prog,$(RNMAKE_DIST_PGMS),\
 # Target:	autohdrs
 # Desc: 	Makes auto-generated header files.
 
-autohdrs: $(EXTRA_AUTOHDRS) $(AUTOHDRS)
+autohdrs: $(EXTRA_AUTOHDRS) $(AUTOHDRS) $(RNMAKE_GEN_HDRS)
 
 # verion.h auto-generated header
 $(AUTO_VERSION_H): $(RNMAKE_PKG_MKFILE)
@@ -736,6 +925,19 @@ $(AUTO_VERSION_H): $(RNMAKE_PKG_MKFILE)
 		pkg_mk=$(RNMAKE_PKG_MKFILE) \
 		autogen
 
+# Template to make a generated source header
+define GENHDRtemplate
+ $(1): $$($(1).SRC) $$(wildcard $$(filter-out /%,$$($(1).GEN)))
+	@$$($(1).GEN) $$($(1).SRC) >$$(@).tmp || { $(RM) $$(@).tmp; false; }
+	@if cmp -s $$(@).tmp $$(@); then $(RM) $$(@).tmp; else \
+		printf "\n$(color_tgt_file)     $$(@)$(color_end)\n"; \
+		$(MV) $$(@).tmp $$(@); fi
+endef
+
+# For each generated header, evaluate (i.e make) the template.
+$(foreach hdr,$(RNMAKE_GEN_HDRS),\
+	$(eval $(call GENHDRtemplate,$(hdr))))
+
 # install.h auto-generated header DEPRECATED
 #$(AUTO_INSTALL_H): $(RNMAKE_ARCH_MKFILE)
 #	@test -d "$(AUTO_INCDIR)" || $(MKDIR) $(AUTO_INCDIR)
@@ -754,6 +956,8 @@ $(AUTO_VERSION_H): $(RNMAKE_PKG_MKFILE)
 # -------------------------------------------------------------------------
 # Target:	hdrs
 # Desc: 	Makes interface header files
+# Notes:	Only headers with changed content are staged, preserving the
+# 				modification times of unchanged headers.
 
 RE_HDR = .*\.h\|.*\.hpp\|.*\.ipp\|.*\.inl
 
@@ -762,7 +966,7 @@ RE_HDR = .*\.h\|.*\.hpp\|.*\.ipp\|.*\.inl
 ifdef RNMAKE_TOP_MAKEFILE
 hdrs: echo-hdrs
 	$(call printGoalWithDesc,$(@),Copying interface headers to $(DISTDIR_INCLUDE))
-	$(call copyTrees,$(RNMAKE_HDR_FILES),$(DISTDIR_INCLUDE))
+	$(call syncTrees,$(RNMAKE_HDR_FILES),$(DISTDIR_INCLUDE),headers)
 else
 hdrs:
 	$(error '$@' $(MSG_ROOT_ONLY))
@@ -955,7 +1159,8 @@ install-lib:
 install-includes: hdrs
 	$(printCurGoal)
 	@printf "Installing includes to $(includedir)\n"
-	@$(RNMAKE_ROOT)/utils/doinstall.sh $(DISTDIR_INCLUDE) $(includedir)
+	@$(RNMAKE_ROOT)/utils/doinstall.sh --changed-only \
+		$(DISTDIR_INCLUDE) $(includedir)
 
 # install documentation
 install-docs: documents
@@ -1041,13 +1246,18 @@ endef
 # If the override variable 'nodeps' is not empty, then no action is performed.
 define includeDeps
 	$(if $(nodeps),,\
-		$(if $(call isFile,$(DEPSFILE)),\
+		$(if $(wildcard $(DEPSFILE)),\
 			$(eval include $(DEPSFILE)),\
 	$(error No dependencies file - Try 'make deps' first)))
 endef
 
 # Conditionally include any dependency file for specific targets only.
-$(if $(call findGoals,all test),$(call includeDeps),)
+# The compiling goals include the per-target goals made by only-build.
+# Nothing is compiled when the distribution is restored from the cache.
+ifndef RNMAKE_CACHE_HIT
+$(if $(call findGoals,all test libs stlibs shlibs dllibs pgms \
+			$(PGMS) $(STLIBS) $(SHLIBS) $(DLLIBS)),$(call includeDeps),)
+endif
 
 # Check deps target
 .PHONY: check-deps
@@ -1096,6 +1306,7 @@ distclean-here: clean-here distclean-dft $(EXTRA_TGT_DISTCLEAN)
 distclean-dft:
 	$(call printGoalWithDesc,distclean,Clobbering $(CURDIR) distribution files)
 	$(RM) $(DEPSFILE)
+	$(RM) $(RNMAKE_GEN_HDRS)
 
 .PHONY: distclean-final
 ifdef RNMAKE_TOP_MAKEFILE
@@ -1196,28 +1407,60 @@ $(OBJDIR)/%.o : %.c
 	$(mkobjdir)
 	@printf "\n"
 	@printf "$(color_tgt_file)     $(<)$(color_end)\n"
-	$(CC) $(CFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
+	$(call compileGate,$(<),$(@)) $(CC) $(CFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
 
 # C++ Rule: <name>.cxx -> $(OBJDIR)/<name>.o
 $(OBJDIR)/%.o : %.cxx
 	$(mkobjdir)
 	@printf "\n"
 	@printf "$(color_tgt_file)     $(<)$(color_end)\n"
-	$(CXX) $(CXXFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
+	$(call compileGate,$(<),$(@)) $(CXX) $(CXXFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
 
 # C++ Rule: <name>.cpp -> $(OBJDIR)/<name>.o
 $(OBJDIR)/%.o : %.cpp
 	$(mkobjdir)
 	@printf "\n"
 	@printf "$(color_tgt_file)     $(<)$(color_end)\n"
-	$(CXX) $(CXXFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
+	$(call compileGate,$(<),$(@)) $(CXX) $(CXXFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
 
 # CUDA Rule: <name>.cu -> $(OBJDIR)/<name>.o
 $(OBJDIR)/%.o : %.cu
 	$(mkobjdir)
 	@printf "\n"
 	@printf "$(color_tgt_file)     $(<)$(color_end)\n"
-	$(CUDA) $(CUDAFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
+	$(call compileGate,$(<),$(@)) $(CUDA) $(CUDAFLAGS) $(CPPFLAGS) $(INCLUDES) -o $(@) -c $(<)
+
+# Microarchitecture Level Rules: <name>.{c|cxx|cpp|cu} -> $(OBJDIR)/<level>/<name>.o
+# A level object also depends on its baseline object $(OBJDIR)/<name>.o, which
+# carries the header dependencies from the dependency file, so a header edit
+# rebuilds the level objects too.
+define MARCHOBJtemplate
+$(OBJDIR)/$(1)/%.o : %.c $(OBJDIR)/%.o
+	@test -d "$$(@D)" || $(MKDIR) "$$(@D)"
+	@printf "\n"
+	@printf "$(color_tgt_file)     $$(<) [$(1)]$(color_end)\n"
+	$$(call compileGate,$$(<),$$(@)) $$(CC) $$(CFLAGS) $(call march_flags,$(1)) $$(CPPFLAGS) $$(INCLUDES) -o $$(@) -c $$(<)
+
+$(OBJDIR)/$(1)/%.o : %.cxx $(OBJDIR)/%.o
+	@test -d "$$(@D)" || $(MKDIR) "$$(@D)"
+	@printf "\n"
+	@printf "$(color_tgt_file)     $$(<) [$(1)]$(color_end)\n"
+	$$(call compileGate,$$(<),$$(@)) $$(CXX) $$(CXXFLAGS) $(call march_flags,$(1)) $$(CPPFLAGS) $$(INCLUDES) -o $$(@) -c $$(<)
+
+$(OBJDIR)/$(1)/%.o : %.cpp $(OBJDIR)/%.o
+	@test -d "$$(@D)" || $(MKDIR) "$$(@D)"
+	@printf "\n"
+	@printf "$(color_tgt_file)     $$(<) [$(1)]$(color_end)\n"
+	$$(call compileGate,$$(<),$$(@)) $$(CXX) $$(CXXFLAGS) $(call march_flags,$(1)) $$(CPPFLAGS) $$(INCLUDES) -o $$(@) -c $$(<)
+
+$(OBJDIR)/$(1)/%.o : %.cu $(OBJDIR)/%.o
+	@test -d "$$(@D)" || $(MKDIR) "$$(@D)"
+	@printf "\n"
+	@printf "$(color_tgt_file)     $$(<) [$(1)]$(color_end)\n"
+	$$(call compileGate,$$(<),$$(@)) $$(CUDA) $$(CUDAFLAGS) $(addprefix -Xcompiler ,$(call march_flags,$(1))) $$(CPPFLAGS) $$(INCLUDES) -o $$(@) -c $$(<)
+endef
+
+$(foreach lvl,$(MARCH_LEVELS),$(eval $(call MARCHOBJtemplate,$(lvl))))
 
 # Compile a single c file. (Nice for debugging)
 %.o : %.c force
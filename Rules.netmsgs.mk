@@ -22,6 +22,12 @@ Include this file in each local make file (usually near the bottom).
 	\li NETMSGS_PYFLAGS		- additional netmsgs python flags.
 	\li NETMSGS_SHARE_DIR	- share directory to copy XML files.
 													default: $(RNMAKE_PKG_ROOT)/share
+	\li NETMSGS_LANGS			- generated languages.
+													default: c python
+
+All XML files are generated for all languages by one run of
+utils/netmsgsmk.py. Generation is skipped for unchanged XML files (content hash
+cache) and generated files are replaced only when their content changes.
 
 \pkgsynopsis
 RN Make System
@@ -84,16 +90,29 @@ NETMSGS_PY_FILES 		= $(addprefix $(NETMSGS_PY_DIR)/,\
 NETMSGS_SHARE_DIR	 ?= $(RNMAKE_PKG_ROOT)/share
 NETMSGS_SHARE_FILES	= $(addprefix $(NETMSGS_SHARE_DIR)/,$(NETMSGS_XML_FILES))
 
-define xml2c
-	$(addprefix $(NETMSGS_C_DIR)/,$(addsuffix .c,$(basename $(1))))
-endef
+# generated languages
+NETMSGS_LANGS      ?= c python
+
+# generated files of requested languages
+NETMSGS_GEN_FILES		= $(if $(filter c,$(NETMSGS_LANGS)),\
+												$(NETMSGS_H_FILES) $(NETMSGS_C_FILES)) \
+											$(if $(filter python,$(NETMSGS_LANGS)),\
+												$(NETMSGS_PY_FILES))
+
+# content hash cache and generation stamp
+NETMSGS_CACHE				= $(OBJDIR)/netmsgs.cache
+NETMSGS_STAMP				= $(OBJDIR)/netmsgs.stamp
+
+# generate again if a generated file is missing
+NETMSGS_MISSING			= $(filter-out $(wildcard $(NETMSGS_GEN_FILES)),\
+												$(NETMSGS_GEN_FILES))
 
 .PHONY: netmsgs-all netmsgs-all-c netmsgs-all-py netmsgs-all-share
 netmsgs-all: echo-netmsgs-all netmsgs-all-c netmsgs-all-py netmsgs-all-share
 
-netmsgs-all-c: 	$(NETMSGS_H_FILES)
+netmsgs-all-c: 	$(filter %.h %.c,$(NETMSGS_GEN_FILES))
 
-netmsgs-all-py: $(NETMSGS_PY_FILES)
+netmsgs-all-py: $(filter %.py,$(NETMSGS_GEN_FILES))
 
 netmsgs-all-share: $(NETMSGS_SHARE_FILES)
 
@@ -103,20 +122,28 @@ netmsgs-clean:
 	$(RM) $(NETMSGS_C_FILES)
 	$(RM) $(NETMSGS_PY_FILES)
 	$(RM) $(NETMSGS_SHARE_FILES)
+	$(RM) $(NETMSGS_CACHE) $(NETMSGS_STAMP)
 
-# Generate NetMsgs C .h and .c message files from XML
-$(NETMSGS_H_DIR)/%.h : %.xml
-	@printf "\n"
-	@printf "$(color_tgt_file)     $(<)$(color_end)\n"
-	@test -d "$(NETMSGS_H_DIR)" || $(MKDIR) $(NETMSGS_H_DIR)
-	$(NETMSGSGEN) --lang=c --xml=$(<) $(NETMSGS_CFLAGS) $(@) $(call xml2c,$(<))
+# Generate NetMsgs source files of all XML files and languages. Unchanged
+# generated files keep their timestamps, so their dependents are not remade.
+$(NETMSGS_GEN_FILES): $(NETMSGS_STAMP) ;
 
-# Generate NetMsgs Python .py files from XML
-$(NETMSGS_PY_DIR)/%.py : %.xml
+.PHONY: netmsgs-force
+$(NETMSGS_STAMP): $(NETMSGS_XML_FILES) $(if $(NETMSGS_MISSING),netmsgs-force)
 	@printf "\n"
-	@printf "$(color_tgt_file)     $(<)$(color_end)\n"
-	@test -d "$(NETMSGS_PY_DIR)" || $(MKDIR) $(NETMSGS_PY_DIR)
-	$(NETMSGSGEN) --lang=python --xml=$(<) $(NETMSGS_PYFLAGS) $(@)
+	@printf "$(color_tgt_file)     $(NETMSGS_XML_FILES)$(color_end)\n"
+	@test -d $(dir $(@)) || $(MKDIR) $(dir $(@))
+	$(PYTHON) $(RNMAKE_ROOT)/utils/netmsgsmk.py \
+		$(if $(call eq,$(color),off),--no-color) \
+		--gen='$(NETMSGSGEN)' \
+		--langs='$(NETMSGS_LANGS)' \
+		--jobs=$(words $(NETMSGS_XML_FILES)) \
+		--cache=$(NETMSGS_CACHE) \
+		--hdir=$(NETMSGS_H_DIR) --cflags='$(NETMSGS_CFLAGS)' \
+		--cdir=$(NETMSGS_C_DIR) \
+		--pydir=$(NETMSGS_PY_DIR) --pyflags='$(NETMSGS_PYFLAGS)' \
+		$(NETMSGS_XML_FILES)
+	@$(TOUCH) $(@)
 
 # Copy NetMsgs XML specification files to share
 $(NETMSGS_SHARE_DIR)/%.xml : %.xml
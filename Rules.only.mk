@@ -0,0 +1,114 @@
+################################################################################
+#
+# Rules.only.mk
+#
+ifdef RNMAKE_DOXY
+/*! 
+\file 
+
+\brief Target-scoped partial builds from the package root.
+
+This file is automatically included by \ref Rules.mk at the package root when
+the only=TARGET[,TARGET...] command-line variable is specified, and in every
+directory for the only-index goal.
+
+The 'only-index' goal writes the package target index $(DISTDIR_TMP)/only.index
+with one line per library and program: kind, name, defining directory, and its
+LIBDEPS library names. With only=, the root 'all' goal (re)makes the index if a
+makefile changed since it was made, then utils/onlymk.py makes just the
+requested targets and their LIBDEPS closure, in dependency order, in their
+defining directories. No other directory is visited.
+
+\pkgsynopsis
+RN Make System
+
+\pkgfile{Rules.only.mk}
+
+\pkgauthor{Robin Knight,robin.knight@roadnarrows.com}
+
+\pkgcopyright{2020,RoadNarrows LLC,http://www.roadnarrows.com}
+
+\LegalBegin
+Copyright (c) 2005-2020 RoadNarrows LLC
+
+Licensed under the MIT License (the "License").
+
+You may not use this file except in compliance with the License. You may
+obtain a copy of the License at:
+
+https://opensource.org/licenses/MIT
+
+The software is provided "AS IS", without warranty of any kind, express or
+implied, including but not limited to the warranties of merchantability,
+fitness for a particular purpose and noninfringement. in no event shall the
+authors or copyright holders be liable for any claim, damages or other
+liability, whether in an action of contract, tort or otherwise, arising from,
+out of or in connection with the software or the use or other dealings in the
+software.
+\LegalEnd
+
+\cond RNMAKE_DOXY
+ */
+endif
+#
+################################################################################
+
+#$(info DBG: $(lastword $(MAKEFILE_LIST)))
+
+export _RULES_ONLY_MK = 1
+
+GOALS_WITH_SUBDIRS += only-index
+
+# package target index
+ONLY_INDEX = $(DISTDIR_TMP)/only.index
+
+# $(call onlyIndexLines,kind,targets)
+# 	Index lines of targets defined in the current directory.
+onlyIndexLines = $(foreach tgt,$(2),$(strip \
+	$(1) $(tgt) $(CURDIR) $(or $($(tgt).LIBDEPS_NAMES),$($(tgt).LIBDEPS)))$(nl))
+
+# newline
+define nl
+
+
+endef
+
+# Make the package target index of the current directory and subdirectories.
+.PHONY: only-index
+only-index: only-index-here subdirs-only-index
+
+.PHONY: only-index-here
+only-index-here:
+	$(shell $(call mkadir,$(DISTDIR_TMP)))
+	$(file $(if $(RNMAKE_TOP_MAKEFILE),>,>>)$(ONLY_INDEX),$(call \
+		onlyIndexLines,lib,$(sort $(STLIBS) $(SHLIBS) $(DLLIBS)))$(call \
+		onlyIndexLines,pgm,$(PGMS)))
+
+ifdef RNMAKE_TOP_MAKEFILE
+ifdef RNMAKE_ONLY
+
+# the root 'all' goal makes only-build
+RNMAKE_ONLY_BUILD = y
+
+# stale if missing or any package makefile is newer
+ONLY_INDEX_STALE := $(if $(wildcard $(ONLY_INDEX)),$(shell \
+	$(FIND) $(RNMAKE_PKG_ROOT) \
+		\( -name .git -o -name dist -o -name loc -o -name obj \) -prune -o \
+		\( -name Makefile -o -name '*.mk' \) -newer $(ONLY_INDEX) -print -quit \
+		2>/dev/null),y)
+
+# Make only the requested targets and their library dependencies.
+.PHONY: only-build
+only-build: $(if $(ONLY_INDEX_STALE),only-index) mkdistdirs mklocdirs autohdrs
+	$(call printGoalWithDesc,$(@),Making $(RNMAKE_ONLY))
+	+@$(PYTHON) $(RNMAKE_ROOT)/utils/onlymk.py \
+		$(if $(call eq,$(color),off),--no-color) \
+		--make='$(MAKE)' --root=$(RNMAKE_PKG_ROOT) \
+		$(ONLY_INDEX) $(RNMAKE_ONLY)
+
+endif
+endif
+
+ifdef RNMAKE_DOXY
+/*! \endcond RNMAKE_DOXY */
+endif
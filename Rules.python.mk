@@ -97,6 +97,10 @@ DISTDIR_PYDOC 			= $(DISTDIR_DOC)/$(PYDOC_DIR)
 DISTDIR_PYDOC_IMG 	= $(DISTDIR_PYDOC)/images
 DISTDIR_PYDOC_HTML 	= $(DISTDIR_PYDOC)/html
 
+# pydoc parallel jobs and per-module source hash cache
+PYDOC_JOBS       ?= $(shell nproc 2>/dev/null || echo 1)
+PYDOC_CACHE				= $(DISTDIR_TMP)/pydoc.$(RNMAKE_PYTHON_PKG).cache
+
 # -------------------------------------------------------------------------
 # Target:	python-all
 #
@@ -144,6 +148,8 @@ python-doc:
 	@$(PYTHON) $(RNMAKE_ROOT)/utils/pydocmk.py \
 		--template="$(RNMAKE_PYDOC_INDEX)" \
 		--images-src-dir=$(RNMAKE_PKG_ROOT)/docs/images \
+		--jobs=$(PYDOC_JOBS) \
+		--cache=$(PYDOC_CACHE) \
 		$(nocolor_opt) \
 		--verbose \
 		org="$(RNMAKE_ORG)" \
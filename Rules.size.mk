@@ -0,0 +1,131 @@
+################################################################################
+#
+# Rules.size.mk
+#
+ifdef RNMAKE_DOXY
+/*! 
+\file 
+
+\brief Binary size and symbol bloat report of built targets.
+
+This file is automatically included by \ref Rules.mk when one or more of the
+size make goals are specified.
+
+The 'size-report' goal reports the text, data, and bss sizes, the largest
+symbols, the template instantiation bloat, and the debug information share of
+all programs and libraries built in the current directory and its
+subdirectories. A JSON snapshot of the report is written to
+$(DISTDIR_TMP)/size-report.json.
+
+The 'size-compare' goal additionally compares the report against a base
+snapshot and fails if any target grew more than the threshold percent.
+
+\code
+make size-report
+make size-compare base=<snapshot.json> [threshold=<percent>]
+\endcode
+
+\pkgsynopsis
+RN Make System
+
+\pkgfile{Rules.size.mk}
+
+\pkgauthor{Robin Knight,robin.knight@roadnarrows.com}
+
+\pkgcopyright{2020,RoadNarrows LLC,http://www.roadnarrows.com}
+
+\LegalBegin
+Copyright (c) 2005-2020 RoadNarrows LLC
+
+Licensed under the MIT License (the "License").
+
+You may not use this file except in compliance with the License. You may
+obtain a copy of the License at:
+
+https://opensource.org/licenses/MIT
+
+The software is provided "AS IS", without warranty of any kind, express or
+implied, including but not limited to the warranties of merchantability,
+fitness for a particular purpose and noninfringement. in no event shall the
+authors or copyright holders be liable for any claim, damages or other
+liability, whether in an action of contract, tort or otherwise, arising from,
+out of or in connection with the software or the use or other dealings in the
+software.
+\LegalEnd
+
+\cond RNMAKE_DOXY
+ */
+endif
+#
+################################################################################
+
+#$(info DBG: $(lastword $(MAKEFILE_LIST)))
+
+export _RULES_SIZE_MK = 1
+
+GOALS_WITH_SUBDIRS += size-targets
+
+# binary tools (override for cross toolchains)
+SIZE    ?= size
+NM      ?= nm
+READELF ?= readelf
+
+export SIZE NM READELF
+
+# list of built targets to report
+SIZE_TARGETS_FILE = $(DISTDIR_TMP)/size.targets
+
+# JSON snapshot
+SIZE_REPORT = $(DISTDIR_TMP)/size-report.json
+
+# 'make size-compare base=<snapshot> threshold=<percent>'
+SIZE_BASE      ?= $(base)
+SIZE_THRESHOLD ?= $(if $(threshold),$(threshold),5)
+
+# number of largest symbols and template groups reported per target
+SIZE_TOP ?= 10
+
+# $(call sizeReport,options)
+# 	Run size report over all listed targets.
+define sizeReport
+	@$(PYTHON) $(RNMAKE_ROOT)/utils/sizemk.py \
+		$(if $(call eq,$(color),off),--no-color) \
+		--top=$(SIZE_TOP) \
+		--root=$(RNMAKE_PKG_ROOT) \
+		--output=$(SIZE_REPORT) \
+		$(1) \
+		$(SIZE_TARGETS_FILE)
+endef
+
+# List built targets of current directory and subdirectories.
+.PHONY: size-targets
+size-targets: size-targets-here subdirs-size-targets
+
+.PHONY: size-targets-here
+size-targets-here:
+	@test -d $(DISTDIR_TMP) || $(MKDIR) $(DISTDIR_TMP)
+	$(foreach tgt,$(wildcard $(FQ_PGMS) $(FQ_SHLIBS) $(FQ_STLIBS) $(FQ_DLLIBS)),\
+		$(file >>$(SIZE_TARGETS_FILE),$(abspath $(tgt))))
+
+# Report sizes of built targets.
+.PHONY: size-report
+size-report: pkg-banner
+	$(call printGoalWithDesc,$(@),Binary size report)
+	@$(RM) $(SIZE_TARGETS_FILE)
+	@$(MAKE) -s --no-print-directory size-targets
+	$(call sizeReport,)
+	$(footer)
+
+# Report sizes and compare against a base snapshot.
+.PHONY: size-compare
+size-compare: pkg-banner
+	$(call printGoalWithDesc,$(@),Binary size comparison)
+	$(if $(SIZE_BASE),,$(error '$@': No base snapshot. Use 'make $@ base=<snapshot.json>'))
+	@$(RM) $(SIZE_TARGETS_FILE)
+	@$(MAKE) -s --no-print-directory size-targets
+	$(call sizeReport,--base=$(SIZE_BASE) --threshold=$(SIZE_THRESHOLD))
+	$(footer)
+
+ifdef RNMAKE_DOXY
+/*! \endcond RNMAKE_DOXY */
+endif
@@ -11,6 +11,14 @@ ifdef RNMAKE_DOXY
 This file is automatically included by \ref Rules.mk when one or more of the
 test make goals are specified.
 
+\par Key RNMAKE Variables:
+	\li RNMAKE_TEST_PGMS	- list of local test programs.
+	\li <test>.DATA			- data input files or directories of test program.
+
+The run-test goal skips a test, reporting it as cached, if its binary, linked
+shared libraries, and data inputs are unchanged since its last passing run.
+Specify force=1 on the command line to run all tests.
+
 \pkgsynopsis
 RN Make System
 
@@ -62,33 +70,42 @@ GOALS_WITH_SUBDIRS += test
 # colors
 color_test = $(color_pre)$(color_light_blue)
 
+# test results cache (force=1 runs all tests)
+TEST_CACHE = $(OBJDIR)/test-results.cache
+
+# $(call testArg,test)
+# 	Test program with its declared data inputs (test.DATA) as TEST:DATA,DATA.
+_test_empty :=
+_test_space := $(_test_empty) $(_test_empty)
+_test_comma := ,
+testArg = $(1)$(if $(strip $($(1).DATA)),:$(subst $(_test_space),$(_test_comma),\
+	$(strip $($(1).DATA))))
+
 # Make specific test programs
 .PHONY: 	test
-test: pkgbanner all subdirs-test
+test: pkg-banner all subdirs-test
 	$(footer)
 
 # Run test programs
 .PHONY: run-test
-run-test: pkgbanner echo-run-test do-test subdirs-run-test
+run-test: pkg-banner echo-run-test do-test subdirs-run-test
 	$(footer)
 
 .PHONY: echo-run-test
 echo-run-test:
-	$(call printEchoTgtGoalDesc,Run all tests)
+	$(call printGoalWithDesc,$(@),Run all tests)
 
+# Tests whose binary, linked libraries, and data inputs are unchanged since
+# their last passing run are skipped and reported as cached.
 .PHONY: do-test
 do-test:
-	@for f in $(RNMAKE_TEST_PGMS); \
-		do \
-			printf "\n$(color_test)         $$f$(color_end)\n"; \
-			if [ -x ./$(LOCDIR_BIN)/$$f ]; \
-			then \
-			  ./$(LOCDIR_BIN)/$$f; \
-			else \
-				printf "$(color_error)Program $$f does not exist. Did you 'make test' first?$(color_end)\n\n"; \
-				break; \
-			fi; \
-	 done;
+	$(if $(RNMAKE_TEST_PGMS),\
+		@$(PYTHON) $(RNMAKE_ROOT)/utils/testmk.py \
+			$(if $(call eq,$(color),off),--no-color) \
+			$(if $(filter-out 0 n no,$(force)),--force) \
+			--cache=$(TEST_CACHE) \
+			$(LOCDIR_BIN) \
+			$(foreach t,$(RNMAKE_TEST_PGMS),$(call testArg,$(t))))
 	$(footer)
 
 
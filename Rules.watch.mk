@@ -0,0 +1,259 @@
+################################################################################
+#
+# Rules.watch.mk
+#
+ifdef RNMAKE_DOXY
+/*! 
+\file 
+
+\brief Continuous rebuild of a package from a warm, flattened build graph.
+
+This file is automatically included by \ref Rules.mk when one or more of the
+watch make goals are specified.
+
+The 'watch-graph' goal writes, for the current directory and all of its
+subdirectories, a small standalone makefile $(OBJDIR)/watch.mk with fully
+expanded generated header, object, microarchitecture level, library, and
+program rules (plus the .deps header dependencies). Watch compiles also write
+per-object dependency files, so headers included while watching are tracked.
+The 'watch' goal at the package root generates the graph once and then runs
+utils/watchmk.py, which waits for source changes and rebuilds from the
+flattened makefiles without re-parsing the rnmake makefiles. The graph and
+the .deps are remade when a makefile changes or a file is added or removed.
+
+\pkgsynopsis
+RN Make System
+
+\pkgfile{Rules.watch.mk}
+
+\pkgauthor{Robin Knight,robin.knight@roadnarrows.com}
+
+\pkgcopyright{2020,RoadNarrows LLC,http://www.roadnarrows.com}
+
+\LegalBegin
+Copyright (c) 2005-2020 RoadNarrows LLC
+
+Licensed under the MIT License (the "License").
+
+You may not use this file except in compliance with the License. You may
+obtain a copy of the License at:
+
+https://opensource.org/licenses/MIT
+
+The software is provided "AS IS", without warranty of any kind, express or
+implied, including but not limited to the warranties of merchantability,
+fitness for a particular purpose and noninfringement. in no event shall the
+authors or copyright holders be liable for any claim, damages or other
+liability, whether in an action of contract, tort or otherwise, arising from,
+out of or in connection with the software or the use or other dealings in the
+software.
+\LegalEnd
+
+\cond RNMAKE_DOXY
+ */
+endif
+#
+################################################################################
+
+#$(info DBG: $(lastword $(MAKEFILE_LIST)))
+
+export _RULES_WATCH_MK = 1
+
+GOALS_WITH_SUBDIRS += watch-graph
+
+# flattened build graph makefile of a directory
+WATCH_GRAPH = $(OBJDIR)/watch.mk
+
+# list of directories with build graphs, in build order
+WATCH_DIRS_FILE = $(DISTDIR_TMP)/watch.dirs
+
+# watcher options
+WATCH_JOBS     ?= $(shell nproc 2>/dev/null || echo 1)
+WATCH_INTERVAL ?= 1
+
+# newline
+define nl
+
+
+endef
+
+# $(call watchObjCmd,src[,level])
+# 	Fully expanded compile command of source file. C and C++ compiles also
+# 	write the object's dependency file.
+watchObjCmd = $(call compileGate,$(1),$(call watchObj,$(1),$(2))) $(strip \
+	$(if $(filter %.cu,$(1)),\
+		$(CUDA) $(CUDAFLAGS) $(addprefix -Xcompiler ,$(call watchMarchFlags,$(2))),\
+	$(if $(filter %.c,$(1)),$(CC) $(CFLAGS),$(CXX) $(CXXFLAGS)) \
+		$(call watchLibCFlags,$(1)) $(call watchMarchFlags,$(2)) \
+		-MMD -MP -MF $(call watchDep,$(1),$(2)))) $(CPPFLAGS) $(INCLUDES) \
+	-o $(call watchObj,$(1),$(2)) -c $(1)
+
+# $(call watchObj,src[,level])
+# 	Object file of source file.
+watchObj = $(OBJDIR)/$(if $(2),$(2)/)$(basename $(1)).o
+
+# $(call watchDep,src[,level])
+# 	Dependency file of source file object.
+watchDep = $(basename $(call watchObj,$(1),$(2))).d
+
+# $(call watchMarchFlags,level)
+# 	Microarchitecture level flags, if any.
+watchMarchFlags = $(if $(1),$(call march_flags,$(1)))
+
+# $(call watchLibCFlags,src)
+# 	Target specific flags inherited from shared and dll libraries.
+watchLibCFlags = \
+	$(if $(filter $(1),$(foreach lib,$(SHLIBS),$(call watchLibSrcs,$(lib)))),\
+		$(SHLIB_CFLAGS))\
+	$(if $(filter $(1),$(foreach lib,$(DLLIBS),$(call watchLibSrcs,$(lib)))),\
+		$(DLLIB_CFLAGS))
+
+# $(call watchLibSrcs,lib)
+# 	C and C++ sources of library.
+watchLibSrcs = $($(1).SRC.C) $($(1).SRC.CXX) $($(1).SRC.CPP)
+
+# all sources of all targets in current directory
+WATCH_SRCS = $(sort $(foreach tgt,$(STLIBS) $(SHLIBS) $(DLLIBS) $(PGMS),\
+	$($(tgt).SRC.C) $($(tgt).SRC.CXX) $($(tgt).SRC.CPP) $($(tgt).SRC.CU)))
+
+# $(call watchGenHdrRule,hdr)
+define watchGenHdrRule
+$(1): $($(1).SRC) $(wildcard $(filter-out /%,$($(1).GEN)))
+	@$($(1).GEN) $($(1).SRC) >$(1).tmp || { $(RM) $(1).tmp; false; }
+	@if cmp -s $(1).tmp $(1); then $(RM) $(1).tmp; else \
+		printf "     $(1)\n"; $(MV) $(1).tmp $(1); fi
+endef
+
+# $(call watchObjRule,src[,level])
+# 	A level object also depends on its baseline object (see MARCHOBJtemplate).
+define watchObjRule
+$(call watchObj,$(1),$(2)): $(1) $(if $(2),$(call watchObj,$(1))) \
+		$(if $(RNMAKE_GEN_HDRS),| $(RNMAKE_GEN_HDRS))
+	@test -d $(dir $(call watchObj,$(1),$(2))) || \
+		$(MKDIR) $(dir $(call watchObj,$(1),$(2)))
+	@printf "     $(1)$(if $(2), [$(2)])\n"
+	$(call watchObjCmd,$(1),$(2))
+endef
+
+# $(call watchObjRules,src)
+# 	Baseline and level object rules of source file.
+define watchObjRules
+$(call watchObjRule,$(1))
+$(foreach lvl,$(MARCH_LEVELS),$(nl)$(call watchObjRule,$(1),$(lvl)))
+endef
+
+# $(call watchLibRules,fqlib,lib,rule)
+# 	Baseline and level library rules of distribution library.
+define watchLibRules
+$(call $(3),$(1),$(2))
+$(call watchMarchLibs,$(1),$(2),$(3))
+endef
+
+# $(call watchMarchLibs,fqlib,lib,rule)
+# 	Level library rules of library and baseline library ordering.
+define watchMarchLibs
+$(foreach lvl,$(MARCH_LEVELS),$(nl)$(call $(3),$(strip \
+	$(if $(filter watchStlibRule,$(3)),\
+		$(dir $(1))$(lvl)/$(notdir $(1)),\
+		$(dir $(1))glibc-hwcaps/$(lvl)/$(notdir $(1)))),$(2),$(lvl)))
+$(if $(MARCH_LEVELS),$(1): | $(strip \
+	$(if $(filter watchStlibRule,$(3)),\
+		$(foreach lvl,$(MARCH_LEVELS),$(dir $(1))$(lvl)/$(notdir $(1))),\
+		$(call march_hwcaps_libs,$(1)))))
+endef
+
+# $(call watchStlibRule,fqlib,lib[,level])
+define watchStlibRule
+$(1): $(call watchLibObjs,$(2),$(3))
+	@test -d $(dir $(1)) || $(MKDIR) $(dir $(1))
+	@printf "     $(1)\n"
+	$(STLIB_LD) $(STLIB_LD_FLAGS) $(STLIB_LD_EXTRAS) $(1) $(call watchLibObjs,$(2),$(3))
+	$(RANLIB) $(1)
+endef
+
+# $(call watchShlibRule,fqlib,lib[,level])
+define watchShlibRule
+$(1): $(call watchLibObjs,$(2),$(3))
+	@test -d $(dir $(1)) || $(MKDIR) $(dir $(1))
+	@printf "     $(1)\n"
+	$(SHLIB_LD) $(SHLIB_LD_FLAGS) $(SHLIB_LD_EXTRAS) -o $(1) $(call watchLibObjs,$(2),$(3)) $(LD_LIBPATHS) $($(2).LIBS) $(LD_LIBS)
+endef
+
+# $(call watchDllibRule,fqlib,lib[,level])
+define watchDllibRule
+$(1): $(call watchLibObjs,$(2),$(3))
+	@test -d $(dir $(1)) || $(MKDIR) $(dir $(1))
+	@printf "     $(1)\n"
+	$(DLLIB_LD) $(DLLIB_LD_FLAGS) $(DLLIB_LD_EXTRAS) $(call watchLibObjs,$(2),$(3)) $(LD_LIBPATHS) $($(2).LIBS) $(LD_LIBS) -o $(1)
+endef
+
+# $(call watchLibObjs,lib[,level])
+# 	Baseline or level objects of library.
+watchLibObjs = $(if $(2),$(call march_objs,$($(1).OBJS),$(2)),$($(1).OBJS))
+
+# $(call watchPgmRule,fqpgm,pgm)
+define watchPgmRule
+$(1): $($(2).OBJS) $($(2).LIBDEPS)
+	@printf "     $(1)\n"
+	$(LD) $(LDFLAGS) $(LD_LIBPATHS) $($(2).OBJS) $($(2).LIBS) $(LD_LIBS) -o $(1)
+endef
+
+# flattened build graph of current directory
+define watchGraph
+# Build graph of $(CURDIR)
+# Auto-generated by rnmake 'watch-graph'. Do not edit.
+.SUFFIXES:
+.DEFAULT_GOAL := watch-all
+.PHONY: watch-all
+watch-all: $(RNMAKE_GEN_HDRS) $(FQ_STLIBS) $(FQ_SHLIBS) $(FQ_DLLIBS) $(FQ_PGMS)
+-include $(DEPSFILE)
+-include $(foreach src,$(WATCH_SRCS),$(call watchDep,$(src)))
+$(foreach hdr,$(RNMAKE_GEN_HDRS),$(nl)$(call watchGenHdrRule,$(hdr)))
+$(foreach src,$(WATCH_SRCS),$(nl)$(call watchObjRules,$(src)))
+$(foreach lib,$(RNMAKE_LOC_STLIBS),$(nl)$(call watchStlibRule,$(strip \
+	$(call fq_stlib_names,$(LOCDIR_LIB),$(lib))),$(lib)))
+$(foreach lib,$(RNMAKE_DIST_STLIBS),$(nl)$(call watchLibRules,$(strip \
+	$(call fq_stlib_names,$(DISTDIR_LIB),$(lib))),$(lib),watchStlibRule))
+$(foreach lib,$(RNMAKE_DIST_SHLIBS),$(nl)$(call watchLibRules,$(strip \
+	$(call fq_shlib_names,$(DISTDIR_LIB),$(lib))),$(lib),watchShlibRule))
+$(foreach lib,$(RNMAKE_DIST_DLLIBS),$(nl)$(call watchLibRules,$(strip \
+	$(call fq_dllib_names,$(DISTDIR_LIB),$(lib))),$(lib),watchDllibRule))
+$(foreach pgm,$(RNMAKE_LOC_PGMS),$(nl)$(call watchPgmRule,$(strip \
+	$(call fq_pgm_names,$(LOCDIR_BIN),$(pgm))),$(pgm)))
+$(foreach pgm,$(RNMAKE_DIST_PGMS),$(nl)$(call watchPgmRule,$(strip \
+	$(call fq_pgm_names,$(DISTDIR_BIN),$(pgm))),$(pgm)))
+endef
+
+# Make the flattened build graphs of the current directory and subdirectories.
+.PHONY: watch-graph
+watch-graph: watch-graph-here subdirs-watch-graph
+
+.PHONY: watch-graph-here
+watch-graph-here:
+	$(shell $(call mkadir,$(OBJDIR)))
+	$(if $(RNMAKE_TOP_MAKEFILE),@$(RM) $(WATCH_DIRS_FILE))
+	$(file >$(WATCH_GRAPH),$(subst $$,$$$$,$(watchGraph)))
+	@test -d $(DISTDIR_TMP) || $(MKDIR) $(DISTDIR_TMP)
+	@echo "$(CURDIR)" >> $(WATCH_DIRS_FILE)
+
+# Watch the package source and continuously rebuild.
+.PHONY: watch
+ifdef RNMAKE_TOP_MAKEFILE
+watch: pkg-banner
+	$(call printGoalWithDesc,$(@),Making build graph)
+	@$(MAKE) -s --no-print-directory watch-graph
+	@$(PYTHON) $(RNMAKE_ROOT)/utils/watchmk.py \
+		$(if $(call eq,$(color),off),--no-color) \
+		--jobs=$(WATCH_JOBS) \
+		--interval=$(WATCH_INTERVAL) \
+		--graph=$(WATCH_GRAPH) \
+		--regen='$(MAKE) -s --no-print-directory -C $(RNMAKE_PKG_ROOT) deps watch-graph' \
+		$(RNMAKE_PKG_ROOT) $(WATCH_DIRS_FILE)
+else
+watch:
+	$(error '$@' $(MSG_ROOT_ONLY))
+endif
+
+ifdef RNMAKE_DOXY
+/*! \endcond RNMAKE_DOXY */
+endif
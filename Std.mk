@@ -136,20 +136,18 @@ endef
 
 # $(call makeSearchPath,dir...)
 # 	Make search path path[:path...].
-define makeSearchPath =
-$(shell 
-			p=""; \
-			for d in $(1); \
-			do \
-				if [ -z "$${p}" ];
-				then \
-					p="$${d}"; \
-				else \
-  				p="$${p}:$${d}"; \
-				fi; \
-			done; \
-			echo "$${p}")
-endef
+makeSearchPath = $(subst $(_std_space),:,$(strip $(1)))
+
+_std_empty :=
+_std_space := $(_std_empty) $(_std_empty)
+
+# $(call findLibDeps,libvpath,lib...)
+# 	Find libraries on the colon separated library search path. For each
+# 	library, the first lib<lib>.so or lib<lib>.a found is listed. Libraries not
+# 	found are ignored. Same as utils/libdeps.sh, but without a subshell since
+# 	it is expanded for each program on every make invocation.
+findLibDeps = $(foreach lib,$(2),$(firstword \
+	$(foreach d,$(subst :, ,$(1)),$(wildcard $(d)/lib$(lib).so $(d)/lib$(lib).a))))
 
 # $(call copyTrees,src...,dstdir)
 # 
@@ -169,6 +167,19 @@ define copyTrees =
 	done
 endef
 
+# $(call syncTrees,src...,dstdir,noun)
+# 
+# Recursively copy directory trees and source files to dstdir, like copyTrees,
+# but only replace destination files whose content has changed. Unchanged
+# destination files keep their modification times so that dependents are not
+# rebuilt. A summary count of changed files is printed.
+#
+# If dstdir does not exist, it is automatically created.
+#
+define syncTrees =
+	@$(RNMAKE_ROOT)/utils/synctree.sh $(if $(3),--what=$(3),) $(1) $(2)
+endef
+
 # $(call copyPat,srcdir,dstdir,pat)
 #
 # Template to recursively copy files from the source directory that match
@@ -69,6 +69,10 @@ RNMAKE_PKG_LIB_SUBDIRS = @PKG_NAME@
 # Link Library Extra Library Directories (exluding local libraries)
 RNMAKE_PKG_LD_LIBDIRS = 
 
+# Workspace packages this package depends on. Their build keys are part of this
+# package's prebuilt distribution cache key (see Rules.cache.mk).
+RNMAKE_PKG_DEPS =
+
 # Release Files (docs)
 RNMAKE_PKG_REL_FILES = VERSION.txt README.md INSTALL.md LICENSE
 
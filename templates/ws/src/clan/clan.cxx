@@ -12,18 +12,24 @@
  */
 
 #include <string>
-#include <map>
 #include <vector>
+#include <unordered_map>
+#include <iterator>
+#include <algorithm>
+#include <random>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <libgen.h>
 #include <unistd.h>
 #include <getopt.h>
 
 #include "utils.h"
 #include "troglodyte.h"
+#include "population.h"
 #include "grammar.h"
 #include "lang.h"
 
@@ -39,75 +45,310 @@ struct args_t
   bool  verbose;    ///< observe plus extraneous information printed
   float iod;        ///< inter-observation delay (seconds);
   int   num_steps;  ///< number of simulation steps
+  std::string grammar_in;   ///< compiled grammar file to load
+  std::string grammar_out;  ///< compiled grammar file to save
+  bool  builtin;    ///< use the built-in static grammar
+  bool  batch;      ///< headless throughput mode
+  int   population; ///< population size, 0 for just the clan
+  unsigned threads; ///< population update threads, 0 for one per core
 };
 
 /*!
- * \brief Clan type
+ * \brief The Clan of the Cave Cricket.
  */
-typedef std::map<std::string, Troglodyte> Clan;
+static const Troglodyte TheClanMembers[] =
+{
+  Troglodyte("Bitey", Troglodyte::Sex::MALE, 6, STURGEON_MOON),
+  Troglodyte("Eet Bugs", Troglodyte::Sex::FEMALE, 7, CORN_MOON),
+  Troglodyte("Gums", Troglodyte::Sex::FEMALE, 29, SNOW_MOON),
+  Troglodyte("Izz", Troglodyte::Sex::FEMALE, 19, BUCK_MOON),
+  Troglodyte("Krell", Troglodyte::Sex::MALE, 2, WORM_MOON),
+  Troglodyte("Mook", Troglodyte::Sex::FEMALE, 22, FLOWER_MOON),
+  Troglodyte("Nogga Ya", Troglodyte::Sex::FEMALE, 20, BEAVER_MOON),
+  Troglodyte("Ogg", Troglodyte::Sex::MALE, 17, STRAWBERRY_MOON),
+  Troglodyte("Old Old Wink", Troglodyte::Sex::MALE, 32, COLD_MOON),
+  Troglodyte("Old Wink", Troglodyte::Sex::MALE, 31, HUNTER_MOON),
+  Troglodyte("Oog the Great", Troglodyte::Sex::MALE, 28, PINK_MOON),
+  Troglodyte("Thag B. Caveman", Troglodyte::Sex::MALE, 24, WOLF_MOON),
+  Troglodyte("Thung", Troglodyte::Sex::FEMALE, 1, WORM_MOON)
+};
 
-/*! Helper macro */
-#define TROG_ELEM(_name, _sex, _age, _moon) \
-  _name, Troglodyte(_name, _sex, _age, _moon)
+/*! Number of clan members. */
+static const size_t NumClanMembers = std::size(TheClanMembers);
 
 /*!
- * \brief The Clan of the Cave Cricket.
+ * \brief Made up names of the wider population.
+ * \{
  */
-static Clan TheClan =
+static const char *FirstNames[] =
 {
-  {TROG_ELEM("Thag B. Caveman", Troglodyte::Sex::MALE, 24, WOLF_MOON)},
-  {TROG_ELEM("Ogg", Troglodyte::Sex::MALE, 17, STRAWBERRY_MOON)},
-  {TROG_ELEM("Nogga Ya", Troglodyte::Sex::FEMALE, 20, BEAVER_MOON)},
-  {TROG_ELEM("Mook", Troglodyte::Sex::FEMALE, 22, FLOWER_MOON)},
-  {TROG_ELEM("Thung", Troglodyte::Sex::FEMALE, 1, WORM_MOON)},
-  {TROG_ELEM("Krell", Troglodyte::Sex::MALE, 2, WORM_MOON)},
-  {TROG_ELEM("Oog the Great", Troglodyte::Sex::MALE, 28, PINK_MOON)},
-  {TROG_ELEM("Izz", Troglodyte::Sex::FEMALE, 19, BUCK_MOON)},
-  {TROG_ELEM("Bitey", Troglodyte::Sex::MALE, 6, STURGEON_MOON)},
-  {TROG_ELEM("Eet Bugs", Troglodyte::Sex::FEMALE, 7, CORN_MOON)},
-  {TROG_ELEM("Gums", Troglodyte::Sex::FEMALE, 29, SNOW_MOON)},
-  {TROG_ELEM("Old Wink", Troglodyte::Sex::MALE, 31, HUNTER_MOON)},
-  {TROG_ELEM("Old Old Wink", Troglodyte::Sex::MALE, 32, COLD_MOON)}
+  "Ag", "Bok", "Dun", "Ekk", "Fub", "Grok", "Hurr", "Ig", "Jub", "Kug", "Lum",
+  "Mog", "Nub", "Ool", "Pog", "Rrr", "Sog", "Tuk", "Ug", "Vrum", "Wug", "Yub",
+  "Zog", "Zuzu"
 };
 
+static const char *Epithets[] =
+{
+  "Big Foot", "Bone Face", "Fire Maker", "Flat Head", "Fleas", "Grunts",
+  "Hairy", "Long Arm", "Loud", "Mud Foot", "No Teeth", "One Eye", "Quick",
+  "Rock Head", "Shiny Rock", "Sniffs", "Spear Hand", "Stinky", "Stone Fist",
+  "Tall", "the Bold", "the Lesser", "Two Toes", "Wide"
+};
+/*! \} */
+
+/*!
+ * \brief The observed population. The clan members come first.
+ */
+static Population ThePopulation;
+
+/*!
+ * \brief Clan members by their own names' grammar subject phrases.
+ */
+static std::unordered_map<Grammar::PhraseId, Population::Id> TheClanSubjects;
+
 /*! Cute name, yes? */
 static std::string TheClanName("Clan of the Cave Cricket");
 
 /*!
- * \brief Add clan proper names to (sub)groups of the grammar.
+ * \brief Age group of troglodyte.
  *
- * \param grammar The grammar.
+ * \param age   Age in birth moons.
  *
- * \return Returns true on success, false otherwise.
+ * \return Returns 0 for adults, 1 for children, 2 for babies.
  */
-static bool add_clan_to_grammar(Grammar &grammar)
+static int age_group(int age)
 {
-  StrVec clan, adults, children, babies;
+  return age >= 14? 0: age >= 4? 1: 2;
+}
 
-  for(Clan::iterator it=TheClan.begin(); it!=TheClan.end(); ++it)
+/*!
+ * \brief Buffered line writer to stdout.
+ *
+ * Lines are assembled in a buffer that is written when it holds at least the
+ * flush threshold. A threshold of 0 writes and flushes every line.
+ */
+class LineWriter
+{
+public:
+  /*!
+   * \brief Initialization constructor.
+   *
+   * \param threshold  Flush threshold (bytes).
+   */
+  LineWriter(size_t threshold) : m_threshold(threshold)
   {
-    Troglodyte &trog = it->second;
-    clan.push_back(trog.name());
-    if( trog.age() >= 14 )
+    m_buf.reserve(threshold + 256);
+  }
+
+  /*!
+   * \brief Destructor. Writes any buffered lines.
+   */
+  ~LineWriter()
+  {
+    flush();
+  }
+
+  /*!
+   * \brief Append text to the current line.
+   *
+   * \param s  Text.
+   *
+   * \return Returns reference to this.
+   */
+  LineWriter &operator<<(const std::string &s)
+  {
+    m_buf.append(s);
+    return *this;
+  }
+
+  /*!
+   * \copydoc operator<<(const std::string &)
+   */
+  LineWriter &operator<<(const char *s)
+  {
+    m_buf.append(s);
+    return *this;
+  }
+
+  /*!
+   * \brief Append step number prefix "  n. " to the current line.
+   *
+   * \param n  Step number.
+   */
+  void step(int n)
+  {
+    char  num[16];
+    int   len = snprintf(num, sizeof(num), "%3d. ", n);
+
+    m_buf.append(num, (size_t)len);
+  }
+
+  /*!
+   * \brief End the current line.
+   */
+  void endl()
+  {
+    m_buf.push_back('\n');
+
+    if( m_buf.size() >= m_threshold )
     {
-      adults.push_back(trog.name());
+      flush();
     }
-    else if( trog.age() >= 4 )
+  }
+
+  /*!
+   * \brief Write buffered lines to stdout and flush.
+   */
+  void flush()
+  {
+    std::cout.write(m_buf.data(), (std::streamsize)m_buf.size());
+    std::cout.flush();
+    m_buf.clear();
+  }
+
+protected:
+  size_t      m_threshold;  ///< flush threshold
+  std::string m_buf;        ///< line buffer
+};
+
+/*!
+ * \brief Histogram of step latencies.
+ *
+ * Log-linear buckets of nanoseconds with 16 sub-buckets per power of 2, so
+ * reported percentiles are within 1/16 of the true values in constant memory
+ * regardless of the number of steps.
+ */
+class LatencyHistogram
+{
+public:
+  /*!
+   * \brief Default constructor.
+   */
+  LatencyHistogram() : m_count(0), m_max(0)
+  {
+    for(size_t i=0; i<NumBuckets; ++i)
     {
-      children.push_back(trog.name());
+      m_buckets[i] = 0;
     }
-    else
+  }
+
+  /*!
+   * \brief Record a latency.
+   *
+   * \param ns   Latency (nanoseconds).
+   */
+  void record(uint64_t ns)
+  {
+    ++m_buckets[bucket(ns)];
+    ++m_count;
+    if( ns > m_max )
+    {
+      m_max = ns;
+    }
+  }
+
+  /*!
+   * \brief Get latency percentile.
+   *
+   * \param pct  Percentile [0.0, 100.0].
+   *
+   * \return Returns upper bound of the percentile's bucket (nanoseconds).
+   */
+  uint64_t percentile(double pct) const
+  {
+    uint64_t  rank = (uint64_t)(pct / 100.0 * (double)m_count + 0.5);
+    uint64_t  sum  = 0;
+
+    if( rank == 0 )
     {
-      babies.push_back(trog.name());
+      rank = 1;
     }
+
+    for(size_t i=0; i<NumBuckets; ++i)
+    {
+      sum += m_buckets[i];
+      if( sum >= rank )
+      {
+        return std::min(upper(i), m_max);
+      }
+    }
+
+    return m_max;
+  }
+
+  /*!
+   * \brief Maximum recorded latency (nanoseconds).
+   */
+  uint64_t max() const
+  {
+    return m_max;
+  }
+
+protected:
+  static const size_t SubBits     = 4;                    ///< sub-bucket bits
+  static const size_t SubBuckets  = 1 << SubBits;         ///< sub-buckets
+  static const size_t NumBuckets  = (64 - SubBits + 1) * SubBuckets;
+
+  /*!
+   * \brief Bucket index of a value.
+   */
+  static size_t bucket(uint64_t v)
+  {
+    if( v < SubBuckets )
+    {
+      return (size_t)v;
+    }
+
+    size_t e = 63 - (size_t)__builtin_clzll(v);   // floor(log2(v)) >= SubBits
+
+    return (e - SubBits + 1) * SubBuckets +
+            (size_t)((v >> (e - SubBits)) & (SubBuckets - 1));
+  }
+
+  /*!
+   * \brief Largest value of a bucket.
+   */
+  static uint64_t upper(size_t i)
+  {
+    if( i < SubBuckets )
+    {
+      return i;
+    }
+
+    size_t    e   = i / SubBuckets + SubBits - 1;
+    uint64_t  sub = i % SubBuckets;
+
+    return ((SubBuckets + sub + 1) << (e - SubBits)) - 1;
+  }
+
+  uint64_t  m_buckets[NumBuckets];  ///< bucket counts
+  uint64_t  m_count;                ///< number of recorded latencies
+  uint64_t  m_max;                  ///< maximum recorded latency
+};
+
+/*!
+ * \brief Add clan proper names to (sub)groups of the grammar.
+ *
+ * \param grammar The grammar.
+ *
+ * \return Returns true on success, false otherwise.
+ */
+static bool add_clan_to_grammar(Grammar &grammar)
+{
+  StrVec clan, groups[3];
+
+  for(const Troglodyte &trog : TheClanMembers)
+  {
+    clan.push_back(trog.name());
+    groups[age_group(trog.age())].push_back(trog.name());
   }
 
   bool  ok = true;
 
   ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "CLAN", clan);
-  ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "ADULTS", adults);
-  ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "URCHINS", children);
-  ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "CAVIES", babies);
+  ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "ADULTS", groups[0]);
+  ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "URCHINS", groups[1]);
+  ok = ok && grammar.add_symbol(Grammar::ESVO::SUBJECT, "CAVIES", groups[2]);
 
   return ok;
 }
@@ -163,75 +404,174 @@ static void dump_grammar(Grammar &grammar)
 }
 
 /*!
- * \brief Make indirect index of the clan.
+ * \brief Populate the observed population.
+ *
+ * The clan members come first. The activities of a member start with the
+ * member's name, if the grammar has it, or else with the stand-in subject of
+ * the member's age group. The rest of the population is troglodytes of made
+ * up names, sexes, ages, and birth moons.
  *
- * \param [in,out] vec    Indirect index vector.
+ * \param grammar The grammar.
+ * \param size    Population size.
  */
-static void index_the_clan(StrVec &vec)
+static void populate(const GrammarView &grammar, size_t size)
 {
-  for(Clan::iterator it=TheClan.begin(); it!=TheClan.end(); ++it)
+  Grammar::PhraseId standin[3] =
   {
-    vec.push_back(it->first);
-  }
-}
+    grammar.phrase_id(Grammar::SUBJECT, "Trog"),
+    grammar.phrase_id(Grammar::SUBJECT, "Mini Trog"),
+    grammar.phrase_id(Grammar::SUBJECT, "Baby Trog")
+  };
 
-static void update_trog(const std::string &activity)
-{
-  for(Clan::iterator it=TheClan.begin(); it!=TheClan.end(); ++it)
+  ThePopulation.clear();
+  ThePopulation.reserve(std::max(size, NumClanMembers));
+  TheClanSubjects.clear();
+
+  for(const Troglodyte &trog : TheClanMembers)
   {
-    Troglodyte &trog = it->second;
+    Grammar::PhraseId subject;
 
-    if( trog.name() == activity )
+    subject = grammar.phrase_id(Grammar::SUBJECT, trog.name());
+
+    if( subject == Grammar::NoPhrase )
     {
-      trog.idle();
-      return;
+      ThePopulation.add(trog, standin[age_group(trog.age())]);
     }
-    else if( activity.find(trog.name()) == 0 )
+    else
     {
-      trog.activity(activity);
-      return;
+      TheClanSubjects[subject] = ThePopulation.add(trog, subject);
     }
   }
-}
 
-static void list_clan_activities()
-{
-  for(Clan::iterator it=TheClan.begin(); it!=TheClan.end(); ++it)
+  std::mt19937  rng(rng_seed());
+  std::string   name;
+
+  for(size_t i=NumClanMembers; i<size; ++i)
   {
-    std::cout << it->second.whatcha_doin() << std::endl;
+    int age = (int)(rng() % 41);
+
+    name.assign(FirstNames[rng() % std::size(FirstNames)]);
+    name.append(" ");
+    name.append(Epithets[rng() % std::size(Epithets)]);
+
+    ThePopulation.add(name,
+                      rng() % 2? Troglodyte::Sex::MALE:
+                                 Troglodyte::Sex::FEMALE,
+                      age,
+                      (FullMoon)(rng() % (COLD_MOON + 1)),
+                      standin[age_group(age)]);
   }
 }
 
 /*!
- * \brief Run clan simulation.
+ * \brief Update the clan member that is the subject of an observation.
  *
- * \param args  Command-line argumets to control simulation.
+ * An observation of just the member idles the member.
  *
- * \return Returns 0 on success, non-zero on failure.
+ * \param sentence  Observed coded sentence.
  */
-static int run_sim(args_t &args)
+static void update_trog(const Grammar::CodedSentence &sentence)
 {
-  Grammar troglodese;
+  auto it = TheClanSubjects.find(sentence.m_phrases[0]);
 
-  if( !preprocess_grammar(troglodese) )
+  if( it == TheClanSubjects.end() )
   {
-    std::cerr << "error: preprocessing grammar '" << Troglodese.name
-              << "' failed" << std::endl;
-    return 8;
+    return;
+  }
+  else if( sentence.m_phrases[1] == Grammar::NoPhrase )
+  {
+    ThePopulation.idle(it->second);
   }
+  else
+  {
+    ThePopulation.activity(it->second, sentence);
+  }
+}
+
+/*!
+ * \brief List the current activities of the clan.
+ *
+ * \param grammar The grammar.
+ * \param out     Output writer.
+ */
+static void list_clan_activities(const GrammarView &grammar,
+                                 LineWriter        &out)
+{
+  std::string doin;
 
-  if( !troglodese.load(Troglodese.name, Troglodese.symbols, Troglodese.rules) )
+  ThePopulation.for_each(0, NumClanMembers, [&](Population::Id i)
   {
-    std::cerr << "error: loading grammar '" << Troglodese.name << "' failed"
-              << std::endl;
+    ThePopulation.whatcha_doin(i, grammar, doin);
+    out << doin;
+    out.endl();
+  });
+}
+
+/*!
+ * \brief Report simulation throughput and step latencies to stderr.
+ *
+ * \param sentences Number of observed sentences.
+ * \param secs      Elapsed time (seconds).
+ * \param lat       Step latencies.
+ */
+static void report_throughput(uint64_t                sentences,
+                              double                  secs,
+                              const LatencyHistogram &lat)
+{
+  std::ios  fmt(nullptr);
+
+  fmt.copyfmt(std::cerr);
+
+  std::cerr << std::fixed << std::setprecision(3);
+  std::cerr << sentences << " sentences in " << secs << " s: "
+            << std::setprecision(0) << (secs > 0.0? sentences / secs: 0.0)
+            << " sentences/s" << std::endl;
+
+  std::cerr << std::setprecision(3) << "step latency (us):"
+            << " p50 " << lat.percentile(50.0) / 1000.0
+            << "  p90 " << lat.percentile(90.0) / 1000.0
+            << "  p99 " << lat.percentile(99.0) / 1000.0
+            << "  p99.9 " << lat.percentile(99.9) / 1000.0
+            << "  max " << lat.max() / 1000.0 << std::endl;
+
+  std::cerr.copyfmt(fmt);
+}
+
+/*!
+ * \brief Save and dump the grammar, as requested.
+ *
+ * \param args      Command-line argumets to control simulation.
+ * \param grammar   The grammar.
+ *
+ * \return Returns 0 on success, non-zero on failure.
+ */
+static int save_and_dump(args_t &args, Grammar &grammar)
+{
+  if( !args.grammar_out.empty() && !grammar.save_compiled(args.grammar_out) )
+  {
+    std::cerr << "error: saving compiled grammar '" << args.grammar_out
+              << "' failed" << std::endl;
     return 8;
   }
 
   if( args.debug )
   {
-    dump_grammar(troglodese);
+    dump_grammar(grammar);
   }
 
+  return 0;
+}
+
+/*!
+ * \brief Simulate the life of the clan.
+ *
+ * \param args      Command-line argumets to control simulation.
+ * \param grammar   The compiled grammar.
+ *
+ * \return Returns 0 on success, non-zero on failure.
+ */
+static int simulate(args_t &args, const GrammarView &grammar)
+{
   if( args.num_steps <= 0 )
   {
     std::cout << std::endl;
@@ -239,28 +579,102 @@ static int run_sim(args_t &args)
     return 0;
   }
 
-  unsigned iod = (unsigned)(args.iod * 1'000'000);
+  unsigned iod = args.batch? 0: (unsigned)(args.iod * 1'000'000);
+
+  populate(grammar, (size_t)args.population);
 
   if( args.verbose )
   {
     std::cout << std::endl;
-    std::cout << "Shh. Observing the clan for " << args.num_steps
-              << " time steps." << std::endl;
+    if( args.population > 0 )
+    {
+      std::cout << "Shh. Observing a population of " << ThePopulation.size()
+                << " troglodytes of " << ThePopulation.num_names()
+                << " names for " << args.num_steps << " time steps."
+                << std::endl;
+    }
+    else
+    {
+      std::cout << "Shh. Observing the clan for " << args.num_steps
+                << " time steps." << std::endl;
+    }
   }
 
+  typedef std::chrono::steady_clock clock;
+
+  LineWriter              out(args.batch? 64 * 1024: 0);
+  LatencyHistogram        lat;
+  Grammar::CodedSentence  coded;
+  GrammarView::IdVec      keys;
+  std::string             activity;
+  uint64_t                seed      = rng_seed();
+  uint64_t                sentences = 0;
+  clock::time_point       start     = clock::now();
+  clock::time_point       t0        = start;
+
   for(int i=0; i<args.num_steps; ++i)
   {
-    const std::string activity = troglodese.random_sentence();
+    // every member of the population acts
+    if( args.population > 0 )
+    {
+      ThePopulation.update(grammar, seed, args.threads, (uint64_t)i);
 
-    update_trog(activity);
+      ThePopulation.for_each([&](Population::Id m)
+      {
+        ThePopulation.whatcha_doin(m, grammar, activity);
 
-    if( args.verbose )
+        if( args.verbose )
+        {
+          out.step(i);
+        }
+        out << activity << ".";
+        out.endl();
+      });
+
+      sentences += ThePopulation.size();
+    }
+
+    // one observation of the world
+    else
     {
-      std::cout << std::setw(3) << std::right << i << ". " << std::setw(0);
+      grammar.random_sentence(seed, (uint64_t)i, keys, coded);
+
+      update_trog(coded);
+
+      grammar.decode(coded, activity);
+
+      if( args.verbose )
+      {
+        out.step(i);
+      }
+      out << activity << ".";
+      out.endl();
+
+      ++sentences;
+    }
+
+    if( iod > 0 )
+    {
+      usleep(iod);
+    }
+
+    if( args.batch )
+    {
+      clock::time_point t1 = clock::now();
+
+      lat.record((uint64_t)
+          std::chrono::duration_cast<std::chrono::nanoseconds>(t1-t0).count());
+      t0 = t1;
     }
-    std::cout << activity << "." << std::endl;
+  }
+
+  out.flush();
+
+  if( args.batch )
+  {
+    std::chrono::duration<double> dt = t0 - start;
 
-    usleep(iod);
+    report_throughput(sentences, dt.count(), lat);
   }
 
   if( args.verbose )
@@ -270,15 +684,90 @@ static int run_sim(args_t &args)
               << TheClanName << "." << std::endl;
     std::cout << std::endl;
 
-    usleep(1'000'000);
+    if( !args.batch )
+    {
+      usleep(1'000'000);
+    }
     std::cout << "As we part ways. let's take a final peek." << std::endl;
 
-    list_clan_activities();
+    list_clan_activities(grammar, out);
   }
 
   return 0;
 }
 
+/*!
+ * \brief Run clan simulation.
+ *
+ * \param args  Command-line argumets to control simulation.
+ *
+ * \return Returns 0 on success, non-zero on failure.
+ */
+static int run_sim(args_t &args)
+{
+  int rc;
+
+  // the built-in tables are used in place, with no grammar built
+  if( args.builtin )
+  {
+    GrammarView builtin;
+
+    if( !builtin.load_tables(TroglodeseTables) )
+    {
+      std::cerr << "error: loading built-in grammar failed" << std::endl;
+      return 8;
+    }
+
+    // saving or dumping needs the full grammar
+    if( !args.grammar_out.empty() || args.debug )
+    {
+      Grammar grammar(TroglodeseTables);
+
+      if( (rc = save_and_dump(args, grammar)) != 0 )
+      {
+        return rc;
+      }
+    }
+
+    return simulate(args, builtin);
+  }
+
+  Grammar         grammar;
+  const Language &troglodese = language();
+
+  if( !args.grammar_in.empty() )
+  {
+    if( !grammar.load_compiled(args.grammar_in) )
+    {
+      std::cerr << "error: loading compiled grammar '" << args.grammar_in
+                << "' failed" << std::endl;
+      return 8;
+    }
+  }
+
+  else if( !preprocess_grammar(grammar) )
+  {
+    std::cerr << "error: preprocessing grammar '" << troglodese.name
+              << "' failed" << std::endl;
+    return 8;
+  }
+
+  else if( !grammar.load(troglodese.name, troglodese.symbols,
+                         troglodese.rules) )
+  {
+    std::cerr << "error: loading grammar '" << troglodese.name << "' failed"
+              << std::endl;
+    return 8;
+  }
+
+  if( (rc = save_and_dump(args, grammar)) != 0 )
+  {
+    return rc;
+  }
+
+  return simulate(args, grammar.compiled());
+}
+
 /*!
  * \brief List clan.
  */
@@ -298,9 +787,8 @@ static void list_clan()
   std::cout << "----------" << std::endl;
   std::cout.fill(prev);
 
-  for(Clan::iterator it=TheClan.begin(); it!=TheClan.end(); ++it)
+  for(const Troglodyte &trog : TheClanMembers)
   {
-    Troglodyte &trog = it->second;
     std::cout << std::setw(18) << std::left << trog.name() << "  ";
     std::cout << std::setw(6) << std::left << Troglodyte::sex_name(trog.sex())
       << "  ";
@@ -330,9 +818,31 @@ Mandatory arguments to long options are mandatory for short options too.
 
   -d, --debug             Debug printing.
 
+      --builtin           Use the static Troglodese grammar compiled in at
+                          build time, instead of building the grammar. Clan
+                          names, stone tools, and fire methods are not added.
+
+      --grammar=FILE      Load the compiled grammar FILE saved by
+                          --save-grammar, instead of building the grammar.
+
+      --save-grammar=FILE Save the compiled grammar to FILE.
+
       --iod=SECONDS       Inter-observation delay (seconds).
                           Default: 0.15
 
+      --population=N      Observe a population of N troglodytes, the clan
+                          plus troglodytes of made up names and ages. Every
+                          member acts every step. Default: 0 (just the clan,
+                          one observation per step)
+
+      --threads=N         Number of threads updating the population.
+                          Default: 0 (one per hardware core)
+
+      --batch             Headless throughput mode. Observations are not
+                          paced and are written in large buffered blocks.
+                          Throughput (sentences/s) and per-step latency
+                          percentiles are reported to stderr at exit.
+
   -h, --help              Print this help.
 )";
 
@@ -365,6 +875,12 @@ static void argparse(int argc, char *argv[], struct args_t &args)
     {"cut-to-the-chase",  no_argument,        NULL,   'c'},
     {"help",              no_argument,        NULL,   'h'},
     {"iod",               required_argument,  NULL,   'i'},
+    {"builtin",           no_argument,        NULL,   'b'},
+    {"grammar",           required_argument,  NULL,   'g'},
+    {"save-grammar",      required_argument,  NULL,   's'},
+    {"batch",             no_argument,        NULL,   'B'},
+    {"population",        required_argument,  NULL,   'p'},
+    {"threads",           required_argument,  NULL,   't'},
     {NULL,                0,                  NULL,   0}
   };
 
@@ -401,6 +917,28 @@ static void argparse(int argc, char *argv[], struct args_t &args)
           args.iod = 0.0;
         }
         break;
+      case 'b':
+        args.builtin = true;
+        break;
+      case 'g':
+        args.grammar_in = optarg;
+        break;
+      case 's':
+        args.grammar_out = optarg;
+        break;
+      case 'B':
+        args.batch = true;
+        break;
+      case 'p':
+        args.population = std::stoi(optarg);
+        if( args.population < 0 )
+        {
+          args.population = 0;
+        }
+        break;
+      case 't':
+        args.threads = (unsigned)std::max(0, std::stoi(optarg));
+        break;
       case '?':   // error
         exit(2);
         break;
@@ -418,7 +956,7 @@ static void argparse(int argc, char *argv[], struct args_t &args)
 
 int main(int argc, char *argv[])
 {
-  struct args_t args = {false, true, 0.15, 10};
+  struct args_t args = {false, true, 0.15, 10, "", "", false, false, 0, 0};
 
   argparse(argc, argv, args);
 
@@ -0,0 +1,150 @@
+/*! \file
+ *
+ * \brief Clan grammar sentence generation benchmark.
+ *
+ * Reports the generation time and heap allocations per sentence of the
+ * sentence generation interfaces of the Grammar and GrammarView classes.
+ *
+ * \pkgfile{@FILENAME@}
+ * \pkgcomponent{Application,clanbench}
+ * \author @PKG_AUTHOR@
+ *
+ * \LegalBegin
+ * @PKG_LICENSE@
+ * \LegalEnd
+ */
+
+#include <string>
+#include <vector>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+#include <stdlib.h>
+
+#include "utils.h"
+#include "grammar.h"
+#include "lang.h"
+
+using namespace clan;
+using namespace clan::troglodese;
+
+/*! Number of heap allocations. */
+static std::atomic<size_t> NumAllocs(0);
+
+/*!
+ * \brief Counting global allocation operators.
+ * \{
+ */
+void *operator new(size_t size)
+{
+  void *p;
+
+  ++NumAllocs;
+
+  if( (p = malloc(size > 0? size: 1)) == nullptr )
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+/*! \} */
+
+/*!
+ * \brief Benchmark one sentence generation interface.
+ *
+ * \param what  Interface name.
+ * \param n     Number of sentences.
+ * \param gen   Generator function gen(n).
+ */
+template<typename Gen>
+static void bench(const char *what, size_t n, Gen &&gen)
+{
+  gen(n);   // warm up buffers
+
+  size_t allocs = NumAllocs;
+  auto   start  = std::chrono::steady_clock::now();
+
+  gen(n);
+
+  std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+
+  allocs = NumAllocs - allocs;
+
+  std::cout << std::setw(36) << std::left << what << std::right
+    << std::setw(12) << std::fixed << std::setprecision(0) << n / dt.count()
+    << std::setw(14) << std::setprecision(3) << (double)allocs / n
+    << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+  size_t          n = argc > 1? (size_t)atol(argv[1]): 200'000;
+  const Language &troglodese = language();
+  Grammar         g;
+
+  if( !g.load(troglodese.name, troglodese.symbols, troglodese.rules) ||
+      !add_stone_tools(g) || !add_fire(g) )
+  {
+    std::cerr << "error: loading grammar '" << troglodese.name << "' failed"
+              << std::endl;
+    return 8;
+  }
+
+  g.compile();
+
+  std::string sentence;
+  StrVec      batch;
+
+  std::cout << std::setw(36) << std::left << "interface" << std::right
+    << std::setw(12) << "sentences/s" << std::setw(14) << "allocs/sent"
+    << std::endl;
+
+  bench("random_sentence()", n, [&](size_t k)
+  {
+    for(size_t i=0; i<k; ++i)
+    {
+      sentence = g.random_sentence();
+    }
+  });
+
+  bench("random_sentence(buffer)", n, [&](size_t k)
+  {
+    for(size_t i=0; i<k; ++i)
+    {
+      g.random_sentence(sentence);
+    }
+  });
+
+  bench("generate_batch(1 thread, buffer)", n, [&](size_t k)
+  {
+    g.generate_batch(k, 1, 1, batch);
+  });
+
+  GrammarView::IdVec keys;
+
+  // the view of the built-in tables is made anew, so its allocations count
+  bench("GrammarView(tables).random_sentence", n, [&](size_t k)
+  {
+    GrammarView view(TroglodeseTables);
+
+    for(size_t i=0; i<k; ++i)
+    {
+      view.random_sentence(1, i, keys, sentence);
+    }
+  });
+
+  return 0;
+}
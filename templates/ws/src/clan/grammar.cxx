@@ -13,24 +13,38 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
 #include <random>
-#include <functional>
-#include <regex>
+#include <thread>
+#include <type_traits>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "utils.h"
 #include "grammar.h"
 
 namespace clan
 {
-  using namespace std::placeholders;
-  
   /*! Map of vector of strings type. */
   typedef std::map<std::string, std::vector<std::string> > MapOfStrVecs;
 
+  /*! Inverted index of phrase to the keys containing the phrase type. */
+  typedef std::unordered_map<std::string, StrVec> PhraseIndex;
+
   /*!
    * \brief Grammer rule pattern.
    */
@@ -38,9 +52,10 @@ namespace clan
   {
     Grammar::ESVO m_part;   ///< part of sentence grammar
     std::string   m_sym;    ///< [non] terminal grammar symbol
+    double        m_weight; ///< relative weight of production
 
-    RulePat(Grammar::ESVO part, const std::string sym)
-      : m_part(part), m_sym(sym)
+    RulePat(Grammar::ESVO part, const std::string sym, double weight = 1.0)
+      : m_part(part), m_sym(sym), m_weight(weight)
     {
     }
 
@@ -51,285 +66,1847 @@ namespace clan
   typedef std::vector<RulePat>  RulePatVec;
 
   /*!
-   * \brief Parse regular expressions.
-   * \{
+   * \brief Walker/Vose alias table for O(1) weighted random choice.
+   *
+   * Column i is kept with probability prob[i], otherwise its alias is chosen.
    */
-  static const std::string ReGrpPart("([svop])");
-  static const std::string ReGrpPhrase("([_A-Za-z0-9 ]+)");
-  static const std::string ReGrpBracketed("(\\[.*\\])?");
-  static const std::regex ReSym(ReGrpPart +":" + ReGrpPhrase + ReGrpBracketed);
-  static const std::regex RePhraseList(ReGrpPhrase + ",?(.*)");
-  static const std::regex ReRule(ReGrpPart + ":" + ReGrpPhrase
-                                 + "[ ]*->[ ]*"
-                                 + ReGrpPart + ":" + ReGrpPhrase);
+  struct AliasTable
+  {
+    std::vector<float>    prob;   ///< probability of keeping column
+    std::vector<uint32_t> alias;  ///< alias of column
+
+    /*!
+     * \brief Build table from relative weights.
+     *
+     * Non-positive weight sums degrade to a uniform choice.
+     *
+     * \param weights   Relative weights.
+     */
+    void build(const DblVec &weights)
+    {
+      size_t                n = weights.size();
+      double                sum = 0.0;
+      std::vector<double>   p(n);
+      std::vector<uint32_t> small, large;
+
+      for(size_t i=0; i<n; ++i)
+      {
+        sum += weights[i] > 0.0? weights[i]: 0.0;
+      }
+
+      for(size_t i=0; i<n; ++i)
+      {
+        p[i] = sum > 0.0? (weights[i] > 0.0? weights[i]: 0.0) * n / sum: 1.0;
+        (p[i] < 1.0? small: large).push_back((uint32_t)i);
+      }
+
+      prob.assign(n, 1.0f);
+      alias.resize(n);
+
+      for(size_t i=0; i<n; ++i)
+      {
+        alias[i] = (uint32_t)i;
+      }
+
+      while( !small.empty() && !large.empty() )
+      {
+        uint32_t s = small.back();
+        uint32_t l = large.back();
+
+        small.pop_back();
+        large.pop_back();
+
+        prob[s]  = (float)p[s];
+        alias[s] = l;
+
+        p[l] = (p[l] + p[s]) - 1.0;
+        (p[l] < 1.0? small: large).push_back(l);
+      }
+    }
+
+    /*!
+     * \brief Weighted random column.
+     *
+     * \param prob  Column probabilities.
+     * \param alias Column aliases.
+     * \param n     Number of columns (n > 0).
+     * \param u     Uniform random number [0, 1).
+     *
+     * \return Column index [0, n).
+     */
+    static uint32_t sample(const float *prob, const uint32_t *alias,
+                           uint32_t n, double u)
+    {
+      double    x = u * n;
+      uint32_t  i = (uint32_t)x;
 
-  /*! \} */
+      if( i >= n )
+      {
+        i = n - 1;
+      }
+      return x - i < prob[i]? i: alias[i];
+    }
+  };
 
   /*!
-   * \brief Grammar internal implementation class.
+   * \brief Counter-based random number stream.
+   *
+   * Stream i of a seed depends only on (seed, i), so a batch of sentences is
+   * reproducible no matter how it is split across threads. The generator is
+   * SplitMix64 started at a hashed (seed, i) state.
    */
-  class Grammar::Impl
+  struct StreamRng
   {
-  public:
+    uint64_t m_state;   ///< generator state
+
     /*!
-     * \brief Default constructor.
+     * \brief Initialization constructor.
+     *
+     * \param seed    Batch seed.
+     * \param stream  Stream (sentence) index.
      */
-    Impl() : m_dist(0, 10'000)
+    StreamRng(uint64_t seed, uint64_t stream)
+      : m_state(mix(seed ^ mix(stream + 0x632be59bd9b4e019ULL)))
     {
-      m_rng.seed(rng_seed());
     }
 
     /*!
-     * \brief Random integer from uniform distribution [0, mod).
+     * \brief SplitMix64 finalizer.
      */
-    int rand(int mod)
+    static uint64_t mix(uint64_t z)
     {
-      return m_dist(m_rng) % mod;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
     }
 
     /*!
-     * \brief Random string from vector of strings.
+     * \brief Next random 64-bit integer.
      */
-    const std::string &rand(const StrVec &vec)
+    uint64_t next()
     {
-      return vec[rand((int)vec.size())];
+      m_state += 0x9e3779b97f4a7c15ULL;
+      return mix(m_state);
+    }
+
+    /*!
+     * \brief Random real from uniform distribution [0, 1).
+     */
+    double real()
+    {
+      return (double)(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /*!
+     * \brief Random integer from uniform distribution [0, n).
+     */
+    uint32_t below(uint32_t n)
+    {
+      return (uint32_t)(((next() >> 32) * n) >> 32);
     }
+  };
+
+  /*!
+   * \brief Phrase weights and their alias table of a dictionary key.
+   */
+  struct KeyWeights
+  {
+    DblVec      weights;  ///< relative weights of the key's phrases
+    AliasTable  table;    ///< phrase alias table
+  };
+
+  /*! Map of key weights type. */
+  typedef std::map<std::string, KeyWeights> MapOfWeights;
+
+  /*!
+   * \brief Compiled grammar binary image format.
+   *
+   * An image is a header, a section table, and the sections. Each section is
+   * a flat array at an 8-byte aligned offset from the start of the image, so
+   * an image is relocatable and is used in place, whether built in memory by
+   * compile or memory mapped from a file saved by save_compiled. Integers are
+   * in the byte order of the machine that built the image.
+   *
+   * Sections in order: language name, string pool characters, string
+   * offsets, nine tables per part of sentence (see Grammar::Tables::Part),
+   * then rule offsets, productions, and the production alias tables.
+   */
+  struct CompiledImage
+  {
+    static constexpr char     Magic[8]  = "CLANGRM";  ///< file magic
+    static constexpr uint32_t Version   = 1;          ///< format version
+    static constexpr uint32_t ByteOrder = 0x01020304; ///< byte order mark
+
+    static constexpr uint32_t PartTables  = 9;  ///< tables per part
+    static constexpr uint32_t NumSections = 3
+                                      + Grammar::NUMOF_ESVOS * PartTables + 4;
 
     /*!
-     * \brief Random map key weighted by size of key vectors.
+     * \brief Image header.
      */
-    const std::string &rand(const MapOfStrVecs &m)
+    struct Header
+    {
+      char      m_magic[8];     ///< magic
+      uint32_t  m_version;      ///< format version
+      uint32_t  m_byte_order;   ///< byte order mark
+      uint64_t  m_size;         ///< image size in bytes
+      uint32_t  m_nsections;    ///< number of sections
+      uint32_t  m_reserved;     ///< reserved (0)
+    };
+
+    /*!
+     * \brief Section table entry.
+     */
+    struct Section
+    {
+      uint64_t  m_offset;       ///< offset from start of image
+      uint64_t  m_count;        ///< number of elements
+    };
+  };
+  /*!
+   * \brief Run worker(i, end) over [0, n) split into contiguous slices, one
+   * per thread.
+   *
+   * \param n       Number of items.
+   * \param threads Number of threads. If 0, then one per hardware core.
+   * \param worker  Worker function.
+   */
+  template<typename Worker>
+  static void parallel_slices(size_t n, unsigned threads, Worker &&worker)
+  {
+    if( threads == 0 )
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if( threads > n )
+    {
+      threads = n > 0? (unsigned)n: 1u;
+    }
+
+    std::vector<std::thread> pool;
+    size_t chunk = n / threads;
+    size_t extra = n % threads;
+    size_t start = 0;
+
+    for(unsigned t=0; t<threads; ++t)
     {
-      size_t  n;
-      MapOfStrVecs::const_iterator it;
+      size_t end = start + chunk + (t < extra? 1: 0);
 
-      // count total number of entries
-      for(n=0, it=m.begin(); it!=m.end(); ++it)
+      if( t + 1 == threads )
       {
-        n += it->second.size();
+        worker(start, end);   // calling thread takes the last slice
       }
+      else
+      {
+        pool.push_back(std::thread(worker, start, end));
+      }
+      start = end;
+    }
+
+    for(size_t t=0; t<pool.size(); ++t)
+    {
+      pool[t].join();
+    }
+  }
 
-      int r = rand(n);
+  // --------------------------------------------------------------------------
+  // GrammarView implementation
+
+  GrammarView::GrammarView(const Grammar::Tables &tables)
+  {
+    load_tables(tables);
+  }
+
+  bool GrammarView::load_tables(const Grammar::Tables &tables)
+  {
+    const char *emsg;
+
+    if( (emsg = attach(tables)) != nullptr )
+    {
+      std::cerr << "error: "
+        << std::string_view(tables.lang.data(), tables.lang.size())
+        << ": " << emsg << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  const char *GrammarView::attach(const Grammar::Tables &tables)
+  {
+    static_cast<Grammar::Tables &>(*this) = tables;
+
+    if( !consistent() )
+    {
+      static_cast<Grammar::Tables &>(*this) = Grammar::Tables();
+      return "inconsistent compiled grammar tables";
+    }
 
-      // find random entry
-      for(n=0, it=m.begin(); it!=m.end(); ++it)
+    return nullptr;
+  }
+
+  bool GrammarView::consistent() const
+  {
+    if( str_off.empty() )
+    {
+      return false;
+    }
+
+    Id    nstr = str_off.size() - 1;
+    bool  ok;
+
+    // offsets into a table are nondecreasing
+    auto nondecreasing = [](const Grammar::Table<Id> &off) -> bool
+    {
+      return std::is_sorted(off.begin(), off.end());
+    };
+
+    // all elements are less than n
+    auto below = [](const Grammar::Table<Id> &ids, uint32_t n) -> bool
+    {
+      return std::all_of(ids.begin(), ids.end(),
+                         [n](uint32_t id) { return id < n; });
+    };
+
+    // row relative aliases are less than their row length
+    auto aliases_in_rows = [](const Grammar::Table<Id> &alias,
+                              const Grammar::Table<Id> &off) -> bool
+    {
+      for(uint32_t row = 0; row + 1 < off.size(); ++row)
       {
-        n += it->second.size();
-        if( r < n )
+        for(uint32_t i = off[row]; i < off[row+1]; ++i)
         {
-          return it->first;
+          if( alias[i] >= off[row+1] - off[row] )
+          {
+            return false;
+          }
         }
       }
-      return m.begin()->first;
+      return true;
+    };
+
+    ok = str_off.back() <= pool.size() &&
+         rule_off.size() == nstr + 1 &&
+         prods.size() == rule_off.back() &&
+         prod_prob.size() == prods.size() &&
+         prod_alias.size() == prods.size();
+
+    for(int part = 0; part < Grammar::NUMOF_ESVOS && ok; ++part)
+    {
+      const Part &p = parts[part];
+
+      ok = p.key_off.size() == p.num_keys() + 1 &&
+           p.key_off.back() == p.phrases.size() &&
+           p.inv_off.size() == nstr + 1 &&
+           p.inv_keys.size() == p.inv_off.back() &&
+           p.phrase_prob.size() == p.phrases.size() &&
+           p.phrase_alias.size() == p.phrases.size() &&
+           p.key_prob.size() == p.num_keys() &&
+           p.key_alias.size() == p.num_keys();
     }
 
-    /*!
-     * \copydoc clan::Grammor::load
-     */
-    bool load(const std::string lang, StrVec &symbols, StrVec &rules)
+    // sizes agree, so element checks stay within the tables
+    ok = ok && nondecreasing(str_off) && nondecreasing(rule_off) &&
+               aliases_in_rows(prod_alias, rule_off);
+
+    for(int part = 0; part < Grammar::NUMOF_ESVOS && ok; ++part)
     {
-      language(lang);
+      const Part &p = parts[part];
+
+      ok = below(p.key_str, nstr) &&
+           nondecreasing(p.key_off) &&
+           below(p.phrases, nstr) &&
+           nondecreasing(p.inv_off) &&
+           below(p.inv_keys, p.num_keys()) &&
+           aliases_in_rows(p.phrase_alias, p.key_off) &&
+           below(p.key_alias, p.num_keys());
+    }
 
-      if( !parse_symbols(symbols) )
+    for(uint32_t i = 0; i < prods.size() && ok; ++i)
+    {
+      ok = prods[i].m_part < Grammar::NUMOF_ESVOS &&
+           prods[i].m_key < parts[prods[i].m_part].num_keys();
+    }
+
+    return ok;
+  }
+
+  size_t GrammarView::find_keys_with_phrase(Grammar::ESVO part, Id phrase,
+                                            IdVec &keys) const
+  {
+    const Part &dict = parts[part];
+
+    if( phrase + 1 < dict.inv_off.size() )
+    {
+      keys.insert(keys.end(),
+                  dict.inv_keys.begin() + dict.inv_off[phrase],
+                  dict.inv_keys.begin() + dict.inv_off[phrase+1]);
+    }
+    return keys.size();
+  }
+
+  template<typename Emit>
+  void GrammarView::random_phrases(uint64_t seed, uint64_t i, IdVec &keys,
+                                   Emit &&emit, Id subject) const
+  {
+    StreamRng     rng(seed, i);
+    Grammar::ESVO part = Grammar::SUBJECT;
+    Id            key  = 0;
+    Id            off, r;
+
+    if( parts[part].phrases.empty() )
+    {
+      return;
+    }
+
+    // key weighted by the total weight of its phrases
+    if( subject == Grammar::NoPhrase )
+    {
+      key = AliasTable::sample(parts[part].key_prob.data(),
+                               parts[part].key_alias.data(),
+                               parts[part].num_keys(), rng.real());
+    }
+
+    for(int depth = 0; depth < Grammar::NUMOF_ESVOS; ++depth)
+    {
+      const Part &dict   = parts[part];
+      Id          phrase = subject;
+
+      if( depth > 0 || subject == Grammar::NoPhrase )
       {
-        return false;
+        off = dict.key_off[key];                // key row offset
+        r   = AliasTable::sample(&dict.phrase_prob[off],
+                                 &dict.phrase_alias[off],
+                                 dict.key_off[key+1] - off,  // terminals
+                                 rng.real());
+        phrase = dict.phrases[off + r];
       }
 
-      else if( !parse_rules(rules) )
+      emit(part, phrase);
+
+      if( depth + 1 >= Grammar::NUMOF_ESVOS )
       {
-        return false;
+        break;
       }
 
-      else
+      // keys containing the phrase, tried at random until one has a rule
+      const Production *prod = nullptr;
+
+      keys.clear();
+      find_keys_with_phrase(part, phrase, keys);
+
+      while( !keys.empty() && prod == nullptr )
       {
-        return true;
+        uint32_t  k     = rng.below((uint32_t)keys.size());
+        Id        rule  = dict.key_str[keys[k]];
+        Id        nprod = num_prods(rule);
+
+        if( nprod > 0 )
+        {
+          off  = rule_off[rule];
+          r    = AliasTable::sample(&prod_prob[off], &prod_alias[off],
+                                    nprod, rng.real());
+          prod = &prods[off + r];
+        }
+        else
+        {
+          keys.erase(keys.begin()+k);
+        }
+      }
+
+      if( prod == nullptr )
+      {
+        break;
+      }
+
+      part = (Grammar::ESVO)prod->m_part;
+      key  = prod->m_key;
+    }
+  }
+
+  void GrammarView::random_sentence(uint64_t seed, uint64_t i, IdVec &keys,
+                                    std::string &sentence) const
+  {
+    sentence.clear();
+
+    random_phrases(seed, i, keys, [&](Grammar::ESVO, Id phrase)
+    {
+      if( !sentence.empty() )
+      {
+        sentence += ' ';
+      }
+      sentence.append(string(phrase));
+    }, Grammar::NoPhrase);
+  }
+
+  void GrammarView::random_sentence(uint64_t seed, uint64_t i, IdVec &keys,
+                                    CodedSentence &sentence,
+                                    PhraseId subject) const
+  {
+    int n = 0;
+
+    random_phrases(seed, i, keys, [&](Grammar::ESVO, Id phrase)
+    {
+      sentence.m_phrases[n++] = phrase;
+    }, subject);
+
+    for(; n<Grammar::NUMOF_ESVOS; ++n)
+    {
+      sentence.m_phrases[n] = Grammar::NoPhrase;
+    }
+  }
+
+  void GrammarView::generate_batch(size_t n,
+                                   uint64_t seed,
+                                   unsigned threads,
+                                   StrVec &sentences,
+                                   uint64_t first) const
+  {
+    sentences.resize(n);
+
+    // each thread fills a contiguous slice of the caller's buffer
+    parallel_slices(n, threads,
+      [this, &sentences, seed, first](size_t i, size_t end)
+      {
+        IdVec keys;    // per thread scratch
+
+        for(; i<end; ++i)
+        {
+          random_sentence(seed, first + i, keys, sentences[i]);
+        }
+      });
+  }
+
+  void GrammarView::generate_batch(size_t n,
+                                   const PhraseId *subjects,
+                                   uint64_t seed,
+                                   unsigned threads,
+                                   PhraseId *const phrases[Grammar::NUMOF_ESVOS],
+                                   uint64_t first) const
+  {
+    // each thread fills a contiguous slice of the caller's columns
+    parallel_slices(n, threads,
+      [this, subjects, phrases, seed, first](size_t i, size_t end)
+      {
+        IdVec         keys;   // per thread scratch
+        CodedSentence coded;
+
+        for(; i<end; ++i)
+        {
+          random_sentence(seed, first + i, keys, coded,
+                          subjects != nullptr? subjects[i]: Grammar::NoPhrase);
+
+          for(int k = 0; k < Grammar::NUMOF_ESVOS; ++k)
+          {
+            if( phrases[k] != nullptr )
+            {
+              phrases[k][i] = coded.m_phrases[k];
+            }
+          }
+        }
+      });
+  }
+
+  GrammarView::PhraseId GrammarView::phrase_id(Grammar::ESVO   part,
+                                               std::string_view phrase) const
+  {
+    for(Id id : parts[part].phrases)
+    {
+      if( string(id) == phrase )
+      {
+        return id;
+      }
+    }
+    return Grammar::NoPhrase;
+  }
+
+  std::string_view GrammarView::phrase(PhraseId id) const
+  {
+    if( id + 1 >= str_off.size() )
+    {
+      return std::string_view();
+    }
+    return string(id);
+  }
+
+  void GrammarView::decode(const CodedSentence &coded,
+                           std::string &sentence) const
+  {
+    sentence.clear();
+
+    for(int n = 0; n < Grammar::NUMOF_ESVOS; ++n)
+    {
+      Id id = coded.m_phrases[n];
+
+      if( id == Grammar::NoPhrase || id + 1 >= str_off.size() )
+      {
+        break;
+      }
+      else if( n > 0 )
+      {
+        sentence += ' ';
       }
+      sentence.append(string(id));
+    }
+  }
+
+  /*!
+   * \brief Compiled, read-only grammar.
+   *
+   * The compiled tables (see Grammar::Tables) are views into one binary image
+   * (see CompiledImage) or into constant tables generated at build time.
+   */
+  struct CompiledGrammar : public GrammarView
+  {
+    const char   *image;      ///< start of image, if any
+    size_t        image_size; ///< image size in bytes
+
+    CompiledGrammar() : image(nullptr), image_size(0)
+    {
     }
 
     /*!
-     * \copydoc clan::Grammor::parse_symbols
+     * \brief Use binary image in place.
+     *
+     * The header and section table are checked, then the tables are validated
+     * once by consistent(). The image must outlive the compiled grammar. On
+     * failure, the compiled grammar is left empty.
+     *
+     * \param data    Start of image (8-byte aligned).
+     * \param size    Image size in bytes.
+     *
+     * \return Returns nullptr on success, an error message otherwise.
      */
-    bool parse_symbols(const StrVec &symbols)
+    const char *attach(const void *data, size_t size)
     {
-      bool good = true;
+      typedef CompiledImage::Header   Header;
+      typedef CompiledImage::Section  Section;
 
-      for(size_t n=0; n<symbols.size() && good; ++n)
+      const char    *base = (const char *)data;
+      const Header  *hdr  = (const Header *)data;
+      const Section *sec  = (const Section *)(base + sizeof(Header));
+      size_t         i    = 0;
+
+      if( size < sizeof(Header) ||
+          std::char_traits<char>::compare(hdr->m_magic, CompiledImage::Magic,
+                                          sizeof(hdr->m_magic)) != 0 )
+      {
+        return "not a compiled grammar";
+      }
+      else if( hdr->m_version != CompiledImage::Version )
+      {
+        return "unsupported compiled grammar version";
+      }
+      else if( hdr->m_byte_order != CompiledImage::ByteOrder )
+      {
+        return "compiled grammar byte order differs from this machine";
+      }
+      else if( hdr->m_size != size ||
+               hdr->m_nsections != CompiledImage::NumSections ||
+               size < sizeof(Header) + sizeof(Section) * hdr->m_nsections )
+      {
+        return "truncated or corrupt compiled grammar";
+      }
+
+      // next section as a view, if in bounds
+      auto view = [&](auto &span) -> bool
       {
-        good = parse_symbol(symbols[n]);
+        typedef std::remove_const_t<std::remove_reference_t<decltype(span[0])>>
+                                                                          T;
+
+        const Section &s = sec[i++];
+
+        if( s.m_offset % 8 != 0 || s.m_offset > size ||
+            s.m_count > (size - s.m_offset) / sizeof(T) ||
+            s.m_count > UINT32_MAX )
+        {
+          return false;
+        }
+        span = {(const T *)(base + s.m_offset), (uint32_t)s.m_count};
+        return true;
+      };
+
+      bool ok = view(lang) && view(pool) && view(str_off);
+
+      for(int part = 0; part < Grammar::NUMOF_ESVOS && ok; ++part)
+      {
+        Part &p = parts[part];
+
+        ok = view(p.key_str) && view(p.key_off) && view(p.phrases) &&
+             view(p.inv_off) && view(p.inv_keys) &&
+             view(p.phrase_prob) && view(p.phrase_alias) &&
+             view(p.key_prob) && view(p.key_alias);
+      }
+
+      ok = ok && view(rule_off) && view(prods) &&
+                 view(prod_prob) && view(prod_alias);
+
+      if( !ok )
+      {
+        *this = CompiledGrammar();
+        return "compiled grammar section out of bounds";
+      }
+      else if( !consistent() )
+      {
+        *this = CompiledGrammar();
+        return "inconsistent compiled grammar tables";
+      }
+
+      image       = base;
+      image_size  = size;
+
+      return nullptr;
+    }
+  };
+
+  /*!
+   * \brief Compiled grammar tables under construction.
+   *
+   * Built by compile from the text form and then written out as a binary
+   * image.
+   */
+  struct GrammarTables
+  {
+    typedef CompiledGrammar::Id           Id;
+    typedef CompiledGrammar::IdVec        IdVec;
+    typedef CompiledGrammar::Production   Production;
+
+    /*!
+     * \brief Dictionary of one part of sentence.
+     */
+    struct Part
+    {
+      IdVec               key_str, key_off, phrases, inv_off, inv_keys;
+      std::vector<float>  phrase_prob;
+      IdVec               phrase_alias;
+      std::vector<float>  key_prob;
+      IdVec               key_alias;
+
+      Id num_keys() const
+      {
+        return (Id)key_str.size();
+      }
+    };
+
+    std::string               lang;       ///< language name
+    std::string               pool;       ///< string pool characters
+    IdVec                     str_off;    ///< string id -> offset into pool
+    Part          parts[Grammar::NUMOF_ESVOS];  ///< part dictionaries
+    IdVec                     rule_off;   ///< string id -> offset into prods
+    std::vector<Production>   prods;      ///< rule productions
+    std::vector<float>        prod_prob;  ///< production alias tables
+    IdVec                     prod_alias; ///< rule relative production aliases
+
+    /*!
+     * \brief View of the tables.
+     */
+    Grammar::Tables tables() const
+    {
+      Grammar::Tables t;
+
+      auto view = [](auto &table, const auto &vec)
+      {
+        table = {vec.data(), (uint32_t)vec.size()};
+      };
+
+      view(t.lang, lang);
+      view(t.pool, pool);
+      view(t.str_off, str_off);
+
+      for(int part = 0; part < Grammar::NUMOF_ESVOS; ++part)
+      {
+        const Part            &p = parts[part];
+        Grammar::Tables::Part &q = t.parts[part];
+
+        view(q.key_str, p.key_str);
+        view(q.key_off, p.key_off);
+        view(q.phrases, p.phrases);
+        view(q.inv_off, p.inv_off);
+        view(q.inv_keys, p.inv_keys);
+        view(q.phrase_prob, p.phrase_prob);
+        view(q.phrase_alias, p.phrase_alias);
+        view(q.key_prob, p.key_prob);
+        view(q.key_alias, p.key_alias);
+      }
+
+      view(t.rule_off, rule_off);
+      view(t.prods, prods);
+      view(t.prod_prob, prod_prob);
+      view(t.prod_alias, prod_alias);
+
+      return t;
+    }
+  };
+
+  /*!
+   * \brief Write binary image of compiled grammar tables.
+   *
+   * \param tables      Compiled grammar tables.
+   * \param [out] image Image bytes.
+   */
+  static void write_image(const Grammar::Tables &tables,
+                          std::vector<char> &image)
+  {
+    typedef CompiledImage::Header   Header;
+    typedef CompiledImage::Section  Section;
+
+    std::vector<Section>  sec;
+
+    image.assign(sizeof(Header)
+                  + sizeof(Section) * CompiledImage::NumSections, 0);
+
+    // append 8-byte aligned section
+    auto add = [&](const auto &table)
+    {
+      image.resize((image.size() + 7) & ~(size_t)7, 0);
+      sec.push_back({image.size(), table.size()});
+      image.insert(image.end(), (const char *)table.begin(),
+                                (const char *)table.end());
+    };
+
+    add(tables.lang);
+    add(tables.pool);
+    add(tables.str_off);
+
+    for(int part = 0; part < Grammar::NUMOF_ESVOS; ++part)
+    {
+      const Grammar::Tables::Part &p = tables.parts[part];
+
+      add(p.key_str);
+      add(p.key_off);
+      add(p.phrases);
+      add(p.inv_off);
+      add(p.inv_keys);
+      add(p.phrase_prob);
+      add(p.phrase_alias);
+      add(p.key_prob);
+      add(p.key_alias);
+    }
+
+    add(tables.rule_off);
+    add(tables.prods);
+    add(tables.prod_prob);
+    add(tables.prod_alias);
+
+    Header hdr;
+
+    std::char_traits<char>::copy(hdr.m_magic, CompiledImage::Magic,
+                                 sizeof(hdr.m_magic));
+    hdr.m_version     = CompiledImage::Version;
+    hdr.m_byte_order  = CompiledImage::ByteOrder;
+    hdr.m_size        = image.size();
+    hdr.m_nsections   = (uint32_t)sec.size();
+    hdr.m_reserved    = 0;
+
+    std::char_traits<char>::copy(image.data(), (const char *)&hdr,
+                                 sizeof(hdr));
+    std::char_traits<char>::copy(image.data() + sizeof(hdr),
+                                 (const char *)sec.data(),
+                                 sizeof(Section) * sec.size());
+  }
+
+  /*!
+   * \brief Read-only memory mapped file.
+   */
+  class MappedFile
+  {
+  public:
+    MappedFile() : m_addr(nullptr), m_size(0)
+    {
+    }
+
+    ~MappedFile()
+    {
+      unmap();
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /*!
+     * \brief Exchange mappings.
+     */
+    void swap(MappedFile &other)
+    {
+      std::swap(m_addr, other.m_addr);
+      std::swap(m_size, other.m_size);
+    }
+
+    /*!
+     * \brief Map file.
+     *
+     * \param path  File path.
+     *
+     * \return Returns true on success, false otherwise (errno is set).
+     */
+    bool map(const std::string &path)
+    {
+      struct stat st;
+      void       *addr;
+      int         fd;
+
+      unmap();
+
+      if( (fd = open(path.c_str(), O_RDONLY)) < 0 )
+      {
+        return false;
+      }
+
+      if( fstat(fd, &st) < 0 || st.st_size == 0 )
+      {
+        if( st.st_size == 0 )
+        {
+          errno = EINVAL;
+        }
+        ::close(fd);
+        return false;
+      }
+
+      addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+      ::close(fd);
+
+      if( addr == MAP_FAILED )
+      {
+        return false;
+      }
+
+      m_addr = addr;
+      m_size = (size_t)st.st_size;
+
+      return true;
+    }
+
+    /*!
+     * \brief Unmap file, if mapped.
+     */
+    void unmap()
+    {
+      if( m_addr != nullptr )
+      {
+        munmap(m_addr, m_size);
+        m_addr = nullptr;
+        m_size = 0;
+      }
+    }
+
+    const void *data() const { return m_addr; }
+    size_t size() const { return m_size; }
+
+  protected:
+    void   *m_addr;   ///< mapped address
+    size_t  m_size;   ///< mapped size
+  };
+
+  /*! string identifier */
+  typedef CompiledGrammar::Id Id;
+
+  /*!
+   * \brief Coded symbol and rule parser.
+   *
+   * A single pass, recursive descent parser of the symbol and rule syntax
+   * documented in grammar.h. Phrases are views into the coded text, trimmed in
+   * place, so nothing is copied until the parsed phrases are added to the
+   * grammar.
+   */
+  class Parser
+  {
+  public:
+    /*!
+     * \brief Parsed phrase.
+     */
+    struct Phrase
+    {
+      std::string_view  m_text;   ///< trimmed phrase text
+      double            m_weight; ///< relative weight (default 1)
+    };
+
+    /*! vector of parsed phrases */
+    typedef std::vector<Phrase> PhraseVec;
+
+    /*!
+     * \brief Initialization constructor.
+     *
+     * \param text    Coded symbol or rule.
+     * \param line    Line number of the coded text, used in error messages.
+     */
+    Parser(std::string_view text, size_t line)
+      : m_text(text), m_pos(0), m_line(line), m_error(nullptr), m_err_pos(0)
+    {
+    }
+
+    /*!
+     * \brief Parse coded symbol.
+     *
+     * \param [out] part      Part of sentence.
+     * \param [out] key       Symbol phrase.
+     * \param [out] list      Bracketed phrase list. Empty if terminal symbol.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool symbol(Grammar::ESVO &part, Phrase &key, PhraseVec &list)
+    {
+      list.clear();
+
+      if( !part_phrase(part, key) )
+      {
+        return false;
+      }
+
+      skip_space();
+
+      if( peek() == '[' )
+      {
+        if( key.m_weight != 1.0 )
+        {
+          return error("a phrase group is weighted by its phrases");
+        }
+
+        ++m_pos;
+
+        do
+        {
+          Phrase item;
+
+          skip_space();
+
+          // trailing comma
+          if( peek() == ']' && !list.empty() )
+          {
+            break;
+          }
+          else if( !phrase(item) )
+          {
+            return false;
+          }
+          list.push_back(item);
+          skip_space();
+        }
+        while( accept(',') );
+
+        if( !expect(']', "expected ',' or ']'") )
+        {
+          return false;
+        }
+      }
+
+      return end();
+    }
+
+    /*!
+     * \brief Parse coded rule.
+     *
+     * \param [out] lhs_part  Left hand side part of sentence.
+     * \param [out] lhs       Left hand side trigger.
+     * \param [out] rhs_part  Right hand side part of sentence.
+     * \param [out] rhs       Right hand side production with its weight.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool rule(Grammar::ESVO &lhs_part, Phrase &lhs,
+              Grammar::ESVO &rhs_part, Phrase &rhs)
+    {
+      if( !part_phrase(lhs_part, lhs) )
+      {
+        return false;
+      }
+      else if( lhs.m_weight != 1.0 )
+      {
+        return error("expected '->' before weight");
+      }
+
+      skip_space();
+
+      if( !expect('-', "expected '->'") || !expect('>', "expected '->'") )
+      {
+        return false;
+      }
+      else if( !part_phrase(rhs_part, rhs) )
+      {
+        return false;
+      }
+
+      return end();
+    }
+
+    /*!
+     * \brief Print parse error with its line and column, and a caret under the
+     * offending character.
+     *
+     * \param what    What was parsed ("symbol" or "rule").
+     */
+    void print_error(const char *what) const
+    {
+      std::cerr << "error: " << what << " " << m_line << ":" << m_err_pos + 1
+        << ": " << (m_error != nullptr? m_error: "invalid") << std::endl
+        << "  " << m_text << std::endl
+        << "  " << std::string(m_err_pos, ' ') << "^" << std::endl;
+    }
+
+  protected:
+    std::string_view  m_text;     ///< coded text
+    size_t            m_pos;      ///< current position in text
+    size_t            m_line;     ///< line number of text
+    const char       *m_error;    ///< error message
+    size_t            m_err_pos;  ///< error position in text
+
+    /*!
+     * \brief Parse part ':' phrase [weight].
+     */
+    bool part_phrase(Grammar::ESVO &part, Phrase &phr)
+    {
+      skip_space();
+
+      switch( peek() )
+      {
+        case 's':
+          part = Grammar::SUBJECT;
+          break;
+        case 'v':
+          part = Grammar::VERB;
+          break;
+        case 'o':
+          part = Grammar::OBJECT;
+          break;
+        case 'p':
+          part = Grammar::PVP;
+          break;
+        default:
+          return error("expected part of sentence 's', 'v', 'o', or 'p'");
+      }
+
+      ++m_pos;
+
+      return expect(':', "expected ':' after part of sentence") && phrase(phr);
+    }
+
+    /*!
+     * \brief Parse phrase [weight].
+     */
+    bool phrase(Phrase &phr)
+    {
+      size_t start, end;
+
+      skip_space();
+
+      start = end = m_pos;
+
+      while( m_pos < m_text.size() && is_phrase_char(m_text[m_pos]) )
+      {
+        if( m_text[m_pos++] != ' ' )
+        {
+          end = m_pos;
+        }
+      }
+
+      if( end == start )
+      {
+        m_pos = start;
+        return error("expected phrase");
+      }
+
+      phr.m_text   = m_text.substr(start, end - start);
+      phr.m_weight = 1.0;
+
+      return accept('@')? weight(phr.m_weight): true;
+    }
+
+    /*!
+     * \brief Parse weight number following '@'.
+     */
+    bool weight(double &w)
+    {
+      double  frac  = 0.1;
+      bool    digit = false;
+
+      skip_space();
+
+      for(w=0.0; is_digit(peek()); ++m_pos, digit=true)
+      {
+        w = w * 10.0 + (m_text[m_pos] - '0');
+      }
+
+      if( accept('.') )
+      {
+        digit = false;
+
+        for(; is_digit(peek()); ++m_pos, frac*=0.1, digit=true)
+        {
+          w += frac * (m_text[m_pos] - '0');
+        }
+      }
+
+      return digit? true: error("expected weight number");
+    }
+
+    /*!
+     * \brief Expect end of text.
+     */
+    bool end()
+    {
+      skip_space();
+
+      return m_pos == m_text.size()? true: error("unexpected character");
+    }
+
+    /*!
+     * \brief Accept character if next.
+     */
+    bool accept(char c)
+    {
+      skip_space();
+
+      if( peek() == c )
+      {
+        ++m_pos;
+        return true;
+      }
+      return false;
+    }
+
+    /*!
+     * \brief Expect character, error if not next.
+     */
+    bool expect(char c, const char *emsg)
+    {
+      return accept(c)? true: error(emsg);
+    }
+
+    /*!
+     * \brief Next character or NUL at end of text.
+     */
+    char peek() const
+    {
+      return m_pos < m_text.size()? m_text[m_pos]: '\0';
+    }
+
+    /*!
+     * \brief Skip spaces.
+     */
+    void skip_space()
+    {
+      while( m_pos < m_text.size() && m_text[m_pos] == ' ' )
+      {
+        ++m_pos;
+      }
+    }
+
+    /*!
+     * \brief Record error at current position.
+     *
+     * \return Returns false.
+     */
+    bool error(const char *emsg)
+    {
+      m_error   = emsg;
+      m_err_pos = m_pos;
+      return false;
+    }
+
+    static bool is_digit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    static bool is_phrase_char(char c)
+    {
+      return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || is_digit(c)
+              || c == '_' || c == ' ';
+    }
+  };
+
+  /*!
+   * \brief Grammar internal implementation class.
+   */
+  class Grammar::Impl
+  {
+  public:
+    /*!
+     * \brief Default constructor.
+     */
+    Impl() : m_dist(0, 10'000), m_dirty(true)
+    {
+      m_rng.seed(rng_seed());
+    }
+
+    /*!
+     * \brief Random integer from uniform distribution [0, mod).
+     */
+    int rand(int mod)
+    {
+      return m_dist(m_rng) % mod;
+    }
+
+    /*!
+     * \brief Random string from vector of strings.
+     */
+    const std::string &rand(const StrVec &vec)
+    {
+      return vec[rand((int)vec.size())];
+    }
+
+    /*!
+     * \copydoc clan::Grammor::load
+     */
+    bool load(const std::string lang,
+              const StrVec &symbols,
+              const StrVec &rules)
+    {
+      language(lang);
+
+      reserve(symbols);
+
+      if( !parse_symbols(symbols) )
+      {
+        return false;
+      }
+
+      else if( !parse_rules(rules) )
+      {
+        return false;
+      }
+
+      else
+      {
+        return true;
+      }
+    }
+
+    /*!
+     * \copydoc clan::Grammor::parse_symbols
+     */
+    bool parse_symbols(const StrVec &symbols)
+    {
+      bool good = true;
+
+      for(size_t n=0; n<symbols.size() && good; ++n)
+      {
+        good = parse_symbol(symbols[n], n+1);
+      }
+
+      return good;
+    }
+
+    /*!
+     * \brief Parse string coded symbol and load into grammar.
+     *
+     * \param symbol  String coded symbol.
+     * \param line    Line number of symbol, used in error messages.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool parse_symbol(std::string_view symbol, size_t line = 1)
+    {
+      Parser          parser(symbol, line);
+      ESVO            part;
+      Parser::Phrase  key;
+
+      if( !parser.symbol(part, key, m_scan_list) )
+      {
+        parser.print_error("symbol");
+        return false;
+      }
+
+      if( m_scan_list.empty() )
+      {
+        return add_symbol(part, std::string(key.m_text), key.m_weight);
+      }
+      else
+      {
+        m_scan_phrases.clear();
+        m_scan_weights.clear();
+
+        for(size_t i=0; i<m_scan_list.size(); ++i)
+        {
+          m_scan_phrases.emplace_back(m_scan_list[i].m_text);
+          m_scan_weights.push_back(m_scan_list[i].m_weight);
+        }
+
+        return add_symbol(part, std::string(key.m_text),
+                          m_scan_phrases, m_scan_weights);
+      }
+    }
+
+    /*!
+     * \copydoc clan::Grammor::parse_rules
+     */
+    bool parse_rules(const StrVec &rules)
+    {
+      bool good = true;
+
+      for(size_t n=0; n<rules.size() && good; ++n)
+      {
+        good = parse_rule(rules[n], n+1);
+      }
+
+      return good;
+    }
+
+    /*!
+     * \brief Parse string coded rule and load into grammar.
+     *
+     * \param rule    String coded rule.
+     * \param line    Line number of rule, used in error messages.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool parse_rule(std::string_view rule, size_t line = 1)
+    {
+      Parser          parser(rule, line);
+      ESVO            lhs_part, rhs_part;
+      Parser::Phrase  lhs, rhs;
+
+      if( !parser.rule(lhs_part, lhs, rhs_part, rhs) )
+      {
+        parser.print_error("rule");
+        return false;
+      }
+
+      return add_rule(lhs_part, std::string(lhs.m_text),
+                      rhs_part, std::string(rhs.m_text), rhs.m_weight);
+    }
+
+    void language(const std::string lang)
+    {
+      m_lang  = lang;
+      m_dirty = true;
+    }
+
+    const std::string &language() const
+    {
+      return m_lang;
+    }
+
+    /*!
+     * \copydoc clan::Grammar::add_symbol
+     */
+    bool add_symbol(ESVO part, const std::string phrase, double weight)
+    {
+      StrVec vec = {phrase};
+
+      MapOfStrVecs::iterator pos = m_dict[part].find(phrase);
+
+      // replaced phrases no longer index the key
+      if( pos != m_dict[part].end() )
+      {
+        unindex(part, phrase, pos->second);
+      }
+
+      m_dict[part][phrase] = vec;
+      index(part, phrase, vec);
+      set_weights(part, phrase, DblVec({weight}), false);
+      m_dirty = true;
+
+      return true;
+    }
+
+    /*!
+     * \copydoc clan::Grammar::add_symbol
+     */
+    bool add_symbol(ESVO part,
+                    const std::string key,
+                    const StrVec &phrases,
+                    const DblVec &weights)
+    {
+      DblVec w(weights);
+
+      w.resize(phrases.size(), 1.0);
+
+      // new
+      if( m_dict[part].find(key) == m_dict[part].end() )
+      {
+        m_dict[part][key] = phrases;
+        set_weights(part, key, w, false);
+      }
+      // join the team
+      else
+      {
+        join(m_dict[part][key], phrases);
+        set_weights(part, key, w, true);
+      }
+      index(part, key, phrases);
+      m_dirty = true;
+
+      // add terminals
+      for(size_t i=0; i<phrases.size(); ++i)
+      {
+        if( !add_symbol(part, phrases[i], w[i]) )
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /*!
+     * \copydoc clan::Grammar::add_rule
+     */
+    bool add_rule(ESVO lhs_part, const std::string lhs,
+                  ESVO rhs_part, const std::string rhs,
+                  double weight)
+    {
+      MapOfStrVecs::iterator pos;
+
+      // checks
+      if( m_dict[lhs_part].find(lhs) == m_dict[lhs_part].end() )
+      {
+        std::cerr << "error: " << esvo_name(lhs_part) << " '" << lhs
+          << "' not found" << std::endl;
+        return false;
+      }
+      else if( m_dict[rhs_part].find(rhs) == m_dict[rhs_part].end() )
+      {
+        std::cerr << "error: " << esvo_name(rhs_part) << " '" << rhs
+          << "' not found" << std::endl;
+        return false;
+      }
+
+      set_rule(lhs, rhs_part, rhs, weight);
+
+      return true;
+    }
+
+    /*!
+     * \copydoc clan::Grammar::compile
+     */
+    void compile()
+    {
+      GrammarTables                         c;
+      std::unordered_map<std::string, Id>   ids;  // string -> identifier
+      std::unordered_map<Id, Id>  keyidx[NUMOF_ESVOS];  // string -> key index
+      DblVec                      key_weights;          // total key weights
+
+      // string offsets are the start of each string until all are interned
+      auto intern = [&](const std::string &str)
+      {
+        auto ins = ids.emplace(str, (Id)c.str_off.size());
+        if( ins.second )
+        {
+          c.str_off.push_back((Id)c.pool.size());
+          c.pool += str;
+        }
+        return ins.first->second;
+      };
+
+      // dictionaries
+      for(int part = SUBJECT; part < NUMOF_ESVOS; ++part)
+      {
+        GrammarTables::Part &dict = c.parts[part];
+        Dictionary::const_iterator dit = m_dict.find((ESVO)part);
+
+        dict.key_off.push_back(0);
+
+        if( dit == m_dict.end() )
+        {
+          continue;
+        }
+
+        for(MapOfStrVecs::const_iterator it=dit->second.begin();
+            it!=dit->second.end();
+            ++it)
+        {
+          Id key = intern(it->first);
+
+          keyidx[part][key] = dict.num_keys();
+          dict.key_str.push_back(key);
+
+          for(StrVec::const_iterator pit=it->second.begin();
+              pit!=it->second.end();
+              ++pit)
+          {
+            dict.phrases.push_back(intern(*pit));
+          }
+          dict.key_off.push_back((Id)dict.phrases.size());
+
+          const KeyWeights &kw = m_weights[part][it->first];
+
+          dict.phrase_prob.insert(dict.phrase_prob.end(),
+                                  kw.table.prob.begin(), kw.table.prob.end());
+          dict.phrase_alias.insert(dict.phrase_alias.end(),
+                                   kw.table.alias.begin(), kw.table.alias.end());
+          key_weights.push_back(sum(kw.weights));
+        }
+
+        // key table weighted by total weight of a key's phrases
+        AliasTable table;
+
+        table.build(key_weights);
+        dict.key_prob   = std::move(table.prob);
+        dict.key_alias  = std::move(table.alias);
+        key_weights.clear();
+      }
+
+      // inverted phrase index, ordered by phrase string identifier
+      for(int part = SUBJECT; part < NUMOF_ESVOS; ++part)
+      {
+        GrammarTables::Part &dict = c.parts[part];
+
+        dict.inv_off.assign(c.str_off.size() + 1, 0);
+
+        for(PhraseIndex::const_iterator it=m_phrase_keys[part].begin();
+            it!=m_phrase_keys[part].end();
+            ++it)
+        {
+          dict.inv_off[ids[it->first] + 1] = (Id)it->second.size();
+        }
+        for(size_t i=1; i<dict.inv_off.size(); ++i)
+        {
+          dict.inv_off[i] += dict.inv_off[i-1];
+        }
+
+        dict.inv_keys.resize(dict.inv_off.back());
+
+        for(PhraseIndex::const_iterator it=m_phrase_keys[part].begin();
+            it!=m_phrase_keys[part].end();
+            ++it)
+        {
+          Id pos = dict.inv_off[ids[it->first]];
+
+          for(StrVec::const_iterator kit=it->second.begin();
+              kit!=it->second.end();
+              ++kit)
+          {
+            dict.inv_keys[pos++] = keyidx[part][ids[*kit]];
+          }
+        }
+      }
+
+      // rules, ordered by left hand side string identifier
+      c.rule_off.assign(c.str_off.size() + 1, 0);
+
+      for(Rules::const_iterator rit=m_rules.begin(); rit!=m_rules.end(); ++rit)
+      {
+        c.rule_off[intern(rit->first) + 1] = (Id)rit->second.size();
+      }
+      for(size_t i=1; i<c.rule_off.size(); ++i)
+      {
+        c.rule_off[i] += c.rule_off[i-1];
+      }
+
+      c.prods.resize(c.rule_off.back());
+      c.prod_prob.resize(c.rule_off.back());
+      c.prod_alias.resize(c.rule_off.back());
+
+      for(Rules::const_iterator rit=m_rules.begin(); rit!=m_rules.end(); ++rit)
+      {
+        Id pos = c.rule_off[intern(rit->first)];
+        const AliasTable &table = m_rule_tables[rit->first];
+
+        for(size_t i=0; i<rit->second.size(); ++i)
+        {
+          const RulePat &pat = rit->second[i];
+
+          c.prods[pos].m_part = pat.m_part;
+          c.prods[pos].m_key  = keyidx[pat.m_part][intern(pat.m_sym)];
+          c.prod_prob[pos]    = table.prob[i];
+          c.prod_alias[pos]   = table.alias[i];
+          ++pos;
+        }
+      }
+
+      c.str_off.push_back((Id)c.pool.size());  // end of string pool
+      c.lang = m_lang;
+
+      m_mapped.unmap();
+      write_image(c.tables(), m_image);
+      m_compiled.attach(m_image.data(), m_image.size());
+      m_dirty = false;
+    }
+
+    /*!
+     * \copydoc clan::Grammar::save_compiled
+     */
+    bool save_compiled(const std::string &path)
+    {
+      std::string tmp(path + ".tmp");
+
+      if( m_dirty )
+      {
+        compile();
+      }
+
+      std::vector<char> image;
+      const char       *data = m_compiled.image;
+      size_t            size = m_compiled.image_size;
+
+      // grammar loaded from constant tables
+      if( data == nullptr )
+      {
+        write_image(m_compiled, image);
+        data = image.data();
+        size = image.size();
+      }
+
+      std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+
+      ofs.write(data, (std::streamsize)size);
+      ofs.close();
+
+      // readers of the old file keep their mapping
+      if( !ofs || rename(tmp.c_str(), path.c_str()) < 0 )
+      {
+        std::cerr << "error: " << path << ": " << strerror(errno) << std::endl;
+        unlink(tmp.c_str());
+        return false;
+      }
+
+      return true;
+    }
+
+    /*!
+     * \copydoc clan::Grammar::load_compiled
+     */
+    bool load_compiled(const std::string &path)
+    {
+      MappedFile      mapped;
+      CompiledGrammar compiled;
+      const char     *emsg;
+
+      if( !mapped.map(path) )
+      {
+        std::cerr << "error: " << path << ": " << strerror(errno) << std::endl;
+        return false;
+      }
+
+      if( (emsg = compiled.attach(mapped.data(), mapped.size())) != nullptr )
+      {
+        std::cerr << "error: " << path << ": " << emsg << std::endl;
+        return false;
       }
 
-      return good;
+      clear_text();
+      m_image.clear();
+
+      m_mapped.swap(mapped);
+      m_compiled  = compiled;
+      m_lang.assign(compiled.lang.data(), compiled.lang.size());
+      m_dirty     = false;
+
+      return true;
     }
 
     /*!
-     * \copydoc clan::Grammor::parse_symbol
+     * \copydoc clan::Grammar::load_tables
      */
-    bool parse_symbol(const std::string &symbol)
+    bool load_tables(const Tables &tables)
     {
-      std::cmatch cm;
+      CompiledGrammar compiled;
 
-      std::regex_match(symbol.c_str(), cm, ReSym);
-
-      if( cm.size() != 4 )
+      if( !compiled.load_tables(tables) )
       {
-        std::cerr << "error: coded symbol '" << symbol << "' is invalid"
-          << std::endl;
         return false;
       }
 
-      ESVO part = char_to_part(trim(cm[1]));
-      std::string sym(trim(cm[2]));
+      clear_text();
+      m_image.clear();
+      m_mapped.unmap();
 
-      if( cm[3] == "" )
-      {
-        return add_symbol(part, sym);
-      }
-      else
-      {
-        StrVec      vec;
-        std::string list(cm[3]);
-        list = list.substr(1,list.size()-2);  // remove bracket cap
+      m_compiled  = compiled;
+      m_lang.assign(compiled.lang.data(), compiled.lang.size());
+      m_dirty     = false;
 
-        while(true)
-        {
-          std::regex_match(list.c_str(), cm, RePhraseList);
-          if( cm.size() != 3 )
-          {
-            break;
-          }
-          else
-          {
-            vec.push_back(trim(cm[1]));
-            list = cm[2];
-          }
-        }
-        return add_symbol(part, sym, vec);
-      }
+      return true;
     }
 
     /*!
-     * \copydoc clan::Grammor::parse_rules
+     * \copydoc clan::Grammar::random_sentence
      */
-    bool parse_rules(const StrVec &rules)
+    std::string random_sentence()
     {
-      bool good = true;
-
-      for(size_t n=0; n<rules.size() && good; ++n)
+      if( m_dirty )
       {
-        good = parse_rule(rules[n]);
+        compile();
       }
 
-      return good;
+      std::string sentence;
+
+      random_sentence(sentence);
+
+      return sentence;
     }
 
     /*!
-     * \copydoc clan::Grammor::parse_rule
+     * \copydoc clan::Grammar::compiled
      */
-    bool parse_rule(const std::string &rule)
+    const GrammarView &compiled()
     {
-      std::cmatch cm;
-
-      std::regex_match(rule.c_str(), cm, ReRule);
-
-      if( cm.size() != 5 )
+      if( m_dirty )
       {
-        std::cerr << "error: coded rule '" << rule << "' is invalid"
-          << std::endl;
-        return false;
+        compile();
       }
 
-      ESVO lhs_part = char_to_part(trim(cm[1]));
-      std::string lhs(trim(cm[2]));
-
-      ESVO rhs_part = char_to_part(trim(cm[3]));
-      std::string rhs(trim(cm[4]));
-
-      return add_rule(lhs_part, lhs, rhs_part, rhs);
+      return m_compiled;
     }
 
-    void language(const std::string lang)
+    /*!
+     * \copydoc clan::Grammar::random_sentence(std::string &)
+     */
+    void random_sentence(std::string &sentence)
     {
-      m_lang = lang;
+      uint64_t seed = ((uint64_t)m_rng() << 32) ^ m_rng();
+
+      compiled().random_sentence(seed, m_rng(), m_keys, sentence);
     }
 
-    const std::string &language() const
+    /*!
+     * \copydoc clan::Grammar::generate_batch
+     */
+    void generate_batch(size_t n,
+                        uint64_t seed,
+                        unsigned threads,
+                        StrVec &sentences,
+                        uint64_t first)
     {
-      return m_lang;
+      compiled().generate_batch(n, seed, threads, sentences, first);
     }
 
     /*!
-     * \copydoc clan::Grammar::add_symbol
+     * \copydoc clan::Grammar::random_sentence(CodedSentence &, PhraseId)
      */
-    bool add_symbol(ESVO part, const std::string phrase)
+    void random_sentence(CodedSentence &sentence, PhraseId subject)
     {
-      StrVec vec = {phrase};
-
-      m_dict[part][phrase] = vec;
+      uint64_t seed = ((uint64_t)m_rng() << 32) ^ m_rng();
 
-      return true;
+      compiled().random_sentence(seed, m_rng(), m_keys, sentence, subject);
     }
 
     /*!
-     * \copydoc clan::Grammar::add_symbol
+     * \copydoc clan::Grammar::generate_batch(size_t, const PhraseId *,
+     * uint64_t, unsigned, PhraseId *const[], uint64_t)
      */
-    bool add_symbol(ESVO part, const std::string key, const StrVec &phrases)
+    void generate_batch(size_t n,
+                        const PhraseId *subjects,
+                        uint64_t seed,
+                        unsigned threads,
+                        PhraseId *const phrases[NUMOF_ESVOS],
+                        uint64_t first)
     {
-      // new
-      if( m_dict[part].find(key) == m_dict[part].end() )
-      {
-        m_dict[part][key] = phrases;
-      }
-      // join the team
-      else
-      {
-        join(m_dict[part][key], phrases);
-      }
-
-      // add terminals
-      for(StrVec::const_iterator it=phrases.begin(); it!=phrases.end(); ++it)
-      {
-        if( !add_symbol(part, *it) )
-        {
-          return false;
-        }
-      }
-      return true;
+      compiled().generate_batch(n, subjects, seed, threads, phrases, first);
     }
 
     /*!
-     * \copydoc clan::Grammar::add_rule
+     * \copydoc clan::Grammar::phrase_id
      */
-    bool add_rule(ESVO lhs_part, const std::string lhs,
-                  ESVO rhs_part, const std::string rhs)
+    PhraseId phrase_id(ESVO part, std::string_view phrase)
     {
-      MapOfStrVecs::iterator pos;
-
-      // checks
-      if( m_dict[lhs_part].find(lhs) == m_dict[lhs_part].end() )
-      {
-        std::cerr << "error: " << esvo_name(lhs_part) << " '" << lhs
-          << "' not found" << std::endl;
-        return false;
-      }
-      else if( m_dict[rhs_part].find(rhs) == m_dict[rhs_part].end() )
-      {
-        std::cerr << "error: " << esvo_name(rhs_part) << " '" << rhs
-          << "' not found" << std::endl;
-        return false;
-      }
-
-      set_rule(lhs, rhs_part, rhs);
+      return compiled().phrase_id(part, phrase);
+    }
 
-      return true;
+    /*!
+     * \copydoc clan::Grammar::phrase
+     */
+    std::string_view phrase(PhraseId id) const
+    {
+      return m_compiled.phrase(id);
     }
 
     /*!
-     * \copydoc clan::Grammar::random_sentence
+     * \copydoc clan::Grammar::decode
      */
-    std::string random_sentence()
+    void decode(const CodedSentence &coded, std::string &sentence) const
     {
-      std::string key = rand(m_dict[SUBJECT]);
-      return random_sentence_r(SUBJECT, key, 0, NUMOF_ESVOS);
+      m_compiled.decode(coded, sentence);
     }
 
     /*!
@@ -362,7 +1939,12 @@ namespace clan
             ++pit)
         {
           std::cout << indent << esvo_name(pit->m_part) << ":'"
-            << pit->m_sym << "'" << std::endl;
+            << pit->m_sym << "'";
+          if( pit->m_weight != 1.0 )
+          {
+            std::cout << " @" << pit->m_weight;
+          }
+          std::cout << std::endl;
         }
       }
     }
@@ -388,12 +1970,13 @@ namespace clan
      * \param rule      Rule.
      * \param depth     Current recursion depth.
      * \param max_depth Maximum allowed recursion depth.
-     * \param cb        Callback void function.
+     * \param cb        Callback cb(part, sym, depth, max_depth).
      */
+    template<typename FiredRule>
     void fire_all(const std::string &rule,
                   int depth,
                   int max_depth,
-                  FiredRuleVoidCallback cb)
+                  FiredRule &&cb)
     {
       if( depth >= max_depth )
       {
@@ -422,14 +2005,16 @@ namespace clan
      * \param rule      Rule.
      * \param depth     Current recursion depth.
      * \param max_depth Maximum allowed recursion depth.
-     * \param cb        Callback function returning string.
+     * \param cb        Callback cb(part, sym, depth, max_depth) returning
+     *                  string.
      *
      * \return Returns generated string.
      */
+    template<typename FiredRule>
     std::string fire_all_string(const std::string &rule,
                                 int depth,
                                 int max_depth,
-                                FiredRuleStringCallback cb)
+                                FiredRule &&cb)
     {
       if( depth >= max_depth )
       {
@@ -460,12 +2045,13 @@ namespace clan
      * \param rule      Rule.
      * \param depth     Current recursion depth.
      * \param max_depth Maximum allowed recursion depth.
-     * \param cb        Callback void function.
+     * \param cb        Callback cb(part, sym, depth, max_depth).
      */
+    template<typename FiredRule>
     void fire_random(const std::string &rule,
                      int depth,
                      int max_depth,
-                     FiredRuleVoidCallback cb)
+                     FiredRule &&cb)
     {
       if( depth >= max_depth )
       {
@@ -481,151 +2067,186 @@ namespace clan
       cb(m_rules[rule][r].m_part, m_rules[rule][r].m_sym, depth, max_depth);
     }
 
+  protected:
     /*!
-     * \brief Fire rule randomly for produce random production from rule.
-     *
-     * ```
-     * rule -> rand_prod
-     * ```
+     * \brief Recursively print generated grammer tree (fragment).
      *
-     * \param rule      Rule.
+     * \param part      Part of sentence.
+     * \param sym       Dictionary symbol.
      * \param depth     Current recursion depth.
      * \param max_depth Maximum allowed recursion depth.
-     * \param cb        Callback function returning string.
-     *
-     * \return Returns generated string.
      */
-    std::string fire_random_string(const std::string &rule,
-                                   int depth,
-                                   int max_depth,
-                                   FiredRuleStringCallback cb)
+    void print_tree_r(ESVO part,
+                      const std::string &sym,
+                      int depth,
+                      int max_depth)
     {
       if( depth >= max_depth )
       {
-        return "";
-      }
-      else if( m_rules.find(rule) == m_rules.end() )
-      {
-        return "";
+        return;
       }
 
-      int r = rand((int)m_rules[rule].size());
+      auto cb = [this](ESVO p, const std::string &s, int d, int m)
+      {
+        print_tree_r(p, s, d, m);
+      };
+      
+      bool nonterm = sym != m_dict[part][sym][0];
 
-      return cb(m_rules[rule][r].m_part,
-                               m_rules[rule][r].m_sym,
-                               depth,
-                               max_depth);
+      for(StrVec::iterator it=m_dict[part][sym].begin();
+          it!=m_dict[part][sym].end();
+          ++it)
+      {
+        std::cout << std::setw(depth*2) << "" << *it << "/" << std::endl;
+        fire_all(*it, depth+1, max_depth, cb);
+        if( nonterm )
+        {
+          fire_all(sym, depth+1, max_depth, cb);
+        }
+      }
     }
 
-  protected:
     /*!
-     * \brief Recursively build random sentence (fragment).
+     * \brief Reserve capacity for a bulk load of coded symbols.
      *
-     * \param part      Part of sentence.
-     * \param key       Dictionary key.
-     * \param depth     Current recursion depth.
-     * \param max_depth Maximum allowed recursion depth.
+     * The number of phrases of each part of sentence is estimated from the
+     * number of symbols and list separators, without parsing.
      *
-     * \return Returns string.
+     * \param symbols Vector of string coded symbols.
      */
-    std::string random_sentence_r(ESVO part,
-                                  const std::string &key,
-                                  int depth,
-                                  int max_depth)
+    void reserve(const StrVec &symbols)
     {
-      if( depth >= max_depth )
+      size_t  nphrases[NUMOF_ESVOS] = {0, 0, 0, 0};
+      size_t  maxlist = 0;
+
+      for(StrVec::const_iterator it=symbols.begin(); it!=symbols.end(); ++it)
       {
-        return "";
-      }
+        size_t  pos = it->find_first_not_of(' ');
+        size_t  n   = 1 + std::count(it->begin(), it->end(), ',');
+        ESVO    part;
 
-      auto cb = std::bind(&Impl::random_sentence_r, this, _1, _2, _3, _4);
-      
-      int n = (int)m_dict[part][key].size();        // number of terminals
+        switch( pos != std::string::npos? (*it)[pos]: '\0' )
+        {
+          case 's': part = SUBJECT; break;
+          case 'v': part = VERB;    break;
+          case 'o': part = OBJECT;  break;
+          default:  part = PVP;     break;
+        }
 
-      // sentence fragments
-      std::string phrase(m_dict[part][key][rand(n)]); // front phrase
-      std::string back_phrases;                       // back phrases
+        nphrases[part] += n;
+        maxlist = std::max(maxlist, n);
+      }
 
-      StrVec keys;
+      for(int part=0; part<NUMOF_ESVOS; ++part)
+      {
+        m_phrase_keys[part].reserve(m_phrase_keys[part].size()+nphrases[part]);
+      }
 
-      find_keys_with_phrase(phrase, m_dict[part], keys);
+      m_scan_list.reserve(maxlist);
+      m_scan_phrases.reserve(maxlist);
+      m_scan_weights.reserve(maxlist);
+    }
 
-      while( keys.size() > 0 )
+    /*!
+     * \brief Clear the text form, replaced by a loaded compiled grammar.
+     */
+    void clear_text()
+    {
+      for(int part = SUBJECT; part < NUMOF_ESVOS; ++part)
       {
-        int r = rand((int)keys.size());
-        back_phrases = fire_random_string(keys[r], depth+1, max_depth, cb);
-        if( !back_phrases.empty() )
-        {
-          break;
-        }
-        keys.erase(keys.begin()+r);
+        m_phrase_keys[part].clear();
+        m_weights[part].clear();
       }
+      m_dict.clear();
+      m_rules.clear();
+      m_rule_tables.clear();
+    }
+
+    /*!
+     * \brief Set or append the phrase weights of a key and rebuild the key's
+     * phrase alias table.
+     *
+     * \param part      Part of sentence.
+     * \param key       Dictionary key.
+     * \param weights   Phrase weights.
+     * \param append    Append to (true) or replace (false) existing weights.
+     */
+    void set_weights(ESVO part,
+                     const std::string &key,
+                     const DblVec &weights,
+                     bool append)
+    {
+      KeyWeights &kw = m_weights[part][key];
 
-      if( back_phrases.empty() )
+      if( append )
       {
-        return phrase;
+        kw.weights.insert(kw.weights.end(), weights.begin(), weights.end());
       }
       else
       {
-        return phrase + " " + back_phrases;
+        kw.weights = weights;
       }
+      kw.table.build(kw.weights);
     }
 
     /*!
-     * \brief Recursively print generated grammer tree (fragment).
-     *
-     * \param part      Part of sentence.
-     * \param sym       Dictionary symbol.
-     * \param depth     Current recursion depth.
-     * \param max_depth Maximum allowed recursion depth.
+     * \brief Sum of weights.
      */
-    void print_tree_r(ESVO part,
-                      const std::string &sym,
-                      int depth,
-                      int max_depth)
+    static double sum(const DblVec &weights)
     {
-      if( depth >= max_depth )
+      double w = 0.0;
+
+      for(DblVec::const_iterator it=weights.begin(); it!=weights.end(); ++it)
       {
-        return;
+        w += *it;
       }
+      return w;
+    }
 
-      auto cb = std::bind(&Impl::print_tree_r, this, _1, _2, _3, _4);
-      
-      bool nonterm = sym != m_dict[part][sym][0];
-
-      for(StrVec::iterator it=m_dict[part][sym].begin();
-          it!=m_dict[part][sym].end();
-          ++it)
+    /*!
+     * \brief Add key to the inverted index entries of its phrases.
+     *
+     * \param part      Part of sentence.
+     * \param key       Dictionary key.
+     * \param phrases   Phrases of key.
+     */
+    void index(ESVO part, const std::string &key, const StrVec &phrases)
+    {
+      for(StrVec::const_iterator it=phrases.begin(); it!=phrases.end(); ++it)
       {
-        std::cout << std::setw(depth*2) << "" << *it << "/" << std::endl;
-        fire_all(*it, depth+1, max_depth, cb);
-        if( nonterm )
+        StrVec &keys = m_phrase_keys[part][*it];
+
+        if( std::find(keys.begin(), keys.end(), key) == keys.end() )
         {
-          fire_all(sym, depth+1, max_depth, cb);
+          keys.push_back(key);
         }
       }
     }
 
     /*!
-     * \brief Map character to part of sentence enum.
+     * \brief Remove key from the inverted index entries of its phrases.
      *
-     * \param c   Character.
-     *
-     * \return Returns ESVO enum.
+     * \param part      Part of sentence.
+     * \param key       Dictionary key.
+     * \param phrases   Phrases of key.
      */
-    ESVO char_to_part(const std::string &s)
+    void unindex(ESVO part, const std::string &key, const StrVec &phrases)
     {
-      switch( s[0] )
+      for(StrVec::const_iterator it=phrases.begin(); it!=phrases.end(); ++it)
       {
-        case 's':
-          return SUBJECT;
-        case 'v':
-          return VERB;
-        case 'o':
-          return OBJECT;
-        case 'p':
-        default:
-          return PVP;
+        PhraseIndex::iterator pos = m_phrase_keys[part].find(*it);
+
+        if( pos != m_phrase_keys[part].end() )
+        {
+          StrVec &keys = pos->second;
+
+          keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+
+          if( keys.empty() )
+          {
+            m_phrase_keys[part].erase(pos);
+          }
+        }
       }
     }
 
@@ -635,42 +2256,37 @@ namespace clan
      * \param lhs       Left hand side trigger.
      * \param rhs_part  Right hand side production part-of-sentence.
      * \param rhs       Right hand side production dictionary key.
+     * \param weight    Relative weight of production.
      */
-    void set_rule(const std::string lhs, ESVO rhs_part, const std::string rhs)
+    void set_rule(const std::string lhs,
+                  ESVO rhs_part,
+                  const std::string rhs,
+                  double weight)
     {
       // new rule
       if( m_rules.find(lhs) == m_rules.end() )
       {
-        m_rules[lhs] = RulePatVec({RulePat(rhs_part, rhs)});
+        m_rules[lhs] = RulePatVec({RulePat(rhs_part, rhs, weight)});
       }
 
       // append to existing rule productions
       else
       {
-        m_rules[lhs].push_back(RulePat(rhs_part, rhs));
+        m_rules[lhs].push_back(RulePat(rhs_part, rhs, weight));
       }
-    }
 
-    size_t find_keys_with_phrase(const std::string phrase,
-                                 const MapOfStrVecs &m,
-                                 StrVec &keys)
-    {
-      MapOfStrVecs::const_iterator mit;
-      StrVec::const_iterator vit;
+      // rebuild only this rule's production alias table
+      DblVec weights;
 
-      // count total number of entries
-      for(mit=m.begin(); mit!=m.end(); ++mit)
+      for(RulePatVec::const_iterator it=m_rules[lhs].begin();
+          it!=m_rules[lhs].end();
+          ++it)
       {
-        for(vit=mit->second.begin(); vit!=mit->second.end(); ++vit)
-        {
-          if( phrase == *vit )
-          {
-            keys.push_back(mit->first);
-            break;
-          }
-        }
+        weights.push_back(it->m_weight);
       }
-      return keys.size();
+      m_rule_tables[lhs].build(weights);
+
+      m_dirty = true;
     }
 
   private:
@@ -680,9 +2296,20 @@ namespace clan
     std::default_random_engine m_rng;           ///< random number generator
     std::uniform_int_distribution<int> m_dist;  ///< uniform distribution
 
-    std::string m_lang;   ///< language name
-    Dictionary  m_dict;   ///< grammar symbols
-    Rules       m_rules;  ///< grammar generative rules
+    std::string     m_lang;       ///< language name
+    Dictionary      m_dict;       ///< grammar symbols
+    PhraseIndex     m_phrase_keys[NUMOF_ESVOS]; ///< phrase to containing keys
+    MapOfWeights    m_weights[NUMOF_ESVOS];     ///< phrase weights
+    Parser::PhraseVec m_scan_list;    ///< parsed phrase list scratch
+    StrVec          m_scan_phrases;   ///< parsed phrases scratch
+    DblVec          m_scan_weights;   ///< parsed phrase weights scratch
+    Rules           m_rules;      ///< grammar generative rules
+    std::map<std::string, AliasTable> m_rule_tables;  ///< production tables
+    CompiledGrammar m_compiled;   ///< compiled grammar
+    std::vector<char> m_image;    ///< compiled grammar image
+    MappedFile      m_mapped;     ///< memory mapped compiled grammar image
+    CompiledGrammar::IdVec m_keys;  ///< sentence generation scratch
+    bool            m_dirty;      ///< compiled grammar is out of date
   };
 
   // --------------------------------------------------------------------------
@@ -720,9 +2347,16 @@ namespace clan
   {
   }
 
+  Grammar::Grammar(const Tables &tables) : pimpl(std::make_unique<Impl>())
+  {
+    pimpl->load_tables(tables);
+  }
+
   Grammar::~Grammar() = default;
 
-  bool Grammar::load(const std::string lang, StrVec &symbols, StrVec &rules)
+  bool Grammar::load(const std::string lang,
+                     const StrVec &symbols,
+                     const StrVec &rules)
   {
     return pimpl->load(lang, symbols, rules);
   }
@@ -732,7 +2366,7 @@ namespace clan
     return pimpl->parse_symbols(symbols);
   }
 
-  bool Grammar::parse_symbol(const std::string &symbol)
+  bool Grammar::parse_symbol(std::string_view symbol)
   {
     return pimpl->parse_symbol(symbol);
   }
@@ -742,7 +2376,7 @@ namespace clan
     return pimpl->parse_rules(rules);
   }
 
-  bool Grammar::parse_rule(const std::string &rule)
+  bool Grammar::parse_rule(std::string_view rule)
   {
     return pimpl->parse_rule(rule);
   }
@@ -757,22 +2391,49 @@ namespace clan
     return pimpl->language();
   }
 
-  bool Grammar::add_symbol(ESVO part, const std::string phrase)
+  bool Grammar::add_symbol(ESVO part, const std::string phrase, double weight)
   {
-    return pimpl->add_symbol(part, phrase);
+    return pimpl->add_symbol(part, phrase, weight);
   }
 
   bool Grammar::add_symbol(ESVO part,
                            const std::string key,
-                           const StrVec &phrases)
+                           const StrVec &phrases,
+                           const DblVec &weights)
   {
-    return pimpl->add_symbol(part, key, phrases);
+    return pimpl->add_symbol(part, key, phrases, weights);
   }
 
   bool Grammar::add_rule(ESVO lhs_part, const std::string lhs,
-                         ESVO rhs_part, const std::string rhs)
+                         ESVO rhs_part, const std::string rhs,
+                         double weight)
+  {
+    return pimpl->add_rule(lhs_part, lhs, rhs_part, rhs, weight);
+  }
+
+  void Grammar::compile()
+  {
+    pimpl->compile();
+  }
+
+  bool Grammar::save_compiled(const std::string &path)
+  {
+    return pimpl->save_compiled(path);
+  }
+
+  bool Grammar::load_compiled(const std::string &path)
+  {
+    return pimpl->load_compiled(path);
+  }
+
+  bool Grammar::load_tables(const Tables &tables)
   {
-    return pimpl->add_rule(lhs_part, lhs, rhs_part, rhs);
+    return pimpl->load_tables(tables);
+  }
+
+  const GrammarView &Grammar::compiled()
+  {
+    return pimpl->compiled();
   }
 
   std::string Grammar::random_sentence()
@@ -780,6 +2441,50 @@ namespace clan
     return pimpl->random_sentence();
   }
 
+  void Grammar::random_sentence(std::string &sentence)
+  {
+    pimpl->random_sentence(sentence);
+  }
+
+  void Grammar::generate_batch(size_t n,
+                               uint64_t seed,
+                               unsigned threads,
+                               StrVec &sentences,
+                               uint64_t first)
+  {
+    pimpl->generate_batch(n, seed, threads, sentences, first);
+  }
+
+  void Grammar::random_sentence(CodedSentence &sentence, PhraseId subject)
+  {
+    pimpl->random_sentence(sentence, subject);
+  }
+
+  void Grammar::generate_batch(size_t n,
+                               const PhraseId *subjects,
+                               uint64_t seed,
+                               unsigned threads,
+                               PhraseId *const phrases[NUMOF_ESVOS],
+                               uint64_t first)
+  {
+    pimpl->generate_batch(n, subjects, seed, threads, phrases, first);
+  }
+
+  Grammar::PhraseId Grammar::phrase_id(ESVO part, std::string_view phrase)
+  {
+    return pimpl->phrase_id(part, phrase);
+  }
+
+  std::string_view Grammar::phrase(PhraseId id) const
+  {
+    return pimpl->phrase(id);
+  }
+
+  void Grammar::decode(const CodedSentence &coded, std::string &sentence) const
+  {
+    pimpl->decode(coded, sentence);
+  }
+
   void Grammar::print_symbols() const
   {
     for(int part = SUBJECT; part < NUMOF_ESVOS; ++part)
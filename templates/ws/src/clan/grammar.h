@@ -18,12 +18,17 @@
 #define _CLAN_GRAMMAR_H
 
 #include <memory>
-#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 
 #include "utils.h"
 
 namespace clan
 {
+  class GrammarView;                ///< forward declaration
+
   /*!
    * \brief Simple grammar class.
    */
@@ -57,18 +62,122 @@ namespace clan
     static const std::string &esvo_name(const ESVO part);
 
     /*!
-     * \brief Fired rule callback types.
+     * \brief Read-only view of a constant table.
+     */
+    template<typename T>
+    struct Table
+    {
+      const T  *m_data = nullptr; ///< first element
+      uint32_t  m_size = 0;       ///< number of elements
+
+      const T &operator[](size_t i) const { return m_data[i]; }
+      const T *data() const { return m_data; }
+      uint32_t size() const { return m_size; }
+      bool empty() const { return m_size == 0; }
+      const T &back() const { return m_data[m_size-1]; }
+      const T *begin() const { return m_data; }
+      const T *end() const { return m_data + m_size; }
+    };
+
+    /*!
+     * \brief Compiled rule production.
+     */
+    struct Production
+    {
+      uint32_t  m_part;   ///< part of sentence of the production
+      uint32_t  m_key;    ///< key index into the part's dictionary
+    };
+
+    /*!
+     * \brief Compiled grammar tables.
+     *
+     * Every key and phrase is interned into an integer string identifier, an
+     * index into the string offsets of the string pool. The dictionary of each
+     * part of sentence is in compressed sparse row (CSR) form: the phrases of
+     * key index k are phrases[key_off[k], key_off[k+1]). The rules are in CSR
+     * form indexed by the string identifier of the left hand side: the
+     * productions of rule s are prods[rule_off[s], rule_off[s+1]). Weighted
+     * choices are Walker/Vose alias tables of probabilities and aliases.
+     *
+     * Constant tables are generated at build time from a language definition
+     * file by langgen.py.
+     */
+    struct Tables
+    {
+      /*!
+       * \brief Dictionary of one part of sentence.
+       */
+      struct Part
+      {
+        Table<uint32_t> key_str;      ///< key index -> key string identifier
+        Table<uint32_t> key_off;      ///< key index -> offset into phrases
+        Table<uint32_t> phrases;      ///< phrase string identifiers
+        Table<uint32_t> inv_off;      ///< phrase string id -> offset into
+                                      ///< inv_keys
+        Table<uint32_t> inv_keys;     ///< key indices of keys containing the
+                                      ///< phrase
+        Table<float>    phrase_prob;  ///< phrase alias tables (per key row)
+        Table<uint32_t> phrase_alias; ///< row relative phrase aliases
+        Table<float>    key_prob;     ///< key alias table (total weights)
+        Table<uint32_t> key_alias;    ///< key aliases
+
+        /*!
+         * \brief Number of keys.
+         */
+        uint32_t num_keys() const
+        {
+          return key_str.size();
+        }
+      };
+
+      Table<char>       lang;         ///< language name
+      Table<char>       pool;         ///< string pool characters
+      Table<uint32_t>   str_off;      ///< string id -> offset into pool
+      Part              parts[NUMOF_ESVOS]; ///< part dictionaries
+      Table<uint32_t>   rule_off;     ///< string id -> offset into prods
+      Table<Production> prods;        ///< rule productions
+      Table<float>      prod_prob;    ///< production alias tables
+      Table<uint32_t>   prod_alias;   ///< rule relative production aliases
+    };
+
+    /*!
+     * \brief Phrase identifier, the interned string identifier of a phrase in
+     * the compiled grammar.
+     *
+     * Identifiers are valid until the grammar is next compiled or loaded.
+     */
+    typedef uint32_t PhraseId;
+
+    static constexpr PhraseId NoPhrase = UINT32_MAX;  ///< no phrase
+
+    /*!
+     * \brief Coded sentence of phrase identifiers.
+     *
+     * A sentence is a chain of at most NUMOF_ESVOS phrases starting with the
+     * subject. The phrases are in sentence order, followed by NoPhrase.
      */
-    typedef std::function<void(ESVO, const std::string &, int, int)> 
-                    FiredRuleVoidCallback;
-    typedef std::function<std::string(ESVO, const std::string&, int, int)>
-                    FiredRuleStringCallback;
+    struct CodedSentence
+    {
+      PhraseId  m_phrases[NUMOF_ESVOS]; ///< phrases in sentence order
+    };
 
     /*!
      * \brief Default constructor.
      */
     Grammar();
 
+    /*!
+     * \brief Compiled tables constructor.
+     *
+     * \copydetails load_tables
+     *
+     * The grammar's private implementation is allocated on the heap. A
+     * GrammarView generates sentences from the tables with no allocation.
+     *
+     * \param tables  Compiled grammar tables.
+     */
+    explicit Grammar(const Tables &tables);
+
     /*!
      * \brief Destructor.
      */
@@ -83,32 +192,39 @@ namespace clan
      * symbols ::= symbol | symbol symbols
      *
      * (* dictionary symbol *)
-     * symbol ::= part ':' phrase
+     * symbol ::= part ':' phrase [weight]
      *          | part ':' phrase '[' phrase-list ']'
      *
      * (* list of rules *)
      * rules ::= rule | rule rules
      *
      * (* rule *)
-     * rule ::= part ':' phrase '->' part ':' phrase
+     * rule ::= part ':' phrase '->' part ':' phrase [weight]
      *
      * (* parts of sentence: subject, verb, object, prepostional/verbal *)
      * part ::= 's' | 'v' | 'o' | 'p'
      *
-     * phrase-list ::= phrase
-     *               | phrase ',' phrase-list
+     * phrase-list ::= phrase [weight]
+     *               | phrase [weight] ',' phrase-list
      *
      * (* alphabetic plus space and underscore *)
      * phrase ::= [_A-Z a-z]+
+     *
+     * (* relative weight of a phrase or production, default 1 *)
+     * weight ::= '@' [0-9]* ['.'] [0-9]+
      * ```
      *
+     * Example: `s:ADULTS -> v:DANGEROUS @0.2`
+     *
      * \param lang    Name of language.
      * \param symbols Vector of string coded symbols.
      * \param rules   Vector of string coded production rules.
      *
      * \return Returns true on success, false otherwise.
      */
-    bool load(const std::string lang, StrVec &symbols, StrVec &rules);
+    bool load(const std::string lang,
+              const StrVec &symbols,
+              const StrVec &rules);
 
     /*!
      * \brief Parse vector of string coded symbols and load into grammar.
@@ -126,7 +242,7 @@ namespace clan
      *
      * \return Returns true on success, false otherwise.
      */
-    bool parse_symbol(const std::string &symbol);
+    bool parse_symbol(std::string_view symbol);
 
     /*!
      * \brief Parse vector of string coded rules and load into grammar.
@@ -144,7 +260,7 @@ namespace clan
      *
      * \return Returns true on success, false otherwise.
      */
-    bool parse_rule(const std::string &rule);
+    bool parse_rule(std::string_view rule);
  
     /*!
      * \brief Set language name.
@@ -165,28 +281,36 @@ namespace clan
      *
      * \param part    Subject, verb, object, pvp sentence part.
      * \param phrase  Phrase to add and it's own group identifier.
+     * \param weight  Relative weight of phrase.
      *
      * \return Returns true on success, false otherwise.
      */
-    bool add_symbol(ESVO part, const std::string phrase);
+    bool add_symbol(ESVO part, const std::string phrase, double weight = 1.0);
 
     /*!
      * \brief Add non-terminal group of terminal phrases to grammar.
      *
+     * Phrases are chosen from a group by their relative weights. Missing
+     * weights default to 1.
+     *
      * \param part    Subject, verb, object, pvp sentence part.
      * \param key     Group identifier non-terminal symbol.
      * \param phrases Vector of phrases to add.
+     * \param weights Vector of relative weights of phrases.
      *
      * \return Returns true on success, false otherwise.
      */
-    bool add_symbol(ESVO part, const std::string key, const StrVec &phrases);
+    bool add_symbol(ESVO part,
+                    const std::string key,
+                    const StrVec &phrases,
+                    const DblVec &weights = DblVec());
 
     /*!
      * \brief Add a grammar production rule to grammer.
      *
      * The symbols must already exist in the symbol dictionary.
      *
-     * The rule may have multiple productions.
+     * The rule may have multiple productions, fired by their relative weights.
      *
      * ```
      * rule -> sym_1
@@ -198,11 +322,79 @@ namespace clan
      * \param lhs       Left hand side trigger.
      * \param rhs_part  Right hand side production part-of-sentence.
      * \param rhs       Right hand side production dictionary key.
+     * \param weight    Relative weight of production.
      *
      * \return Returns true on success, false otherwise.
      */
     bool add_rule(ESVO lhs_part, const std::string lhs,
-                  ESVO rhs_part, const std::string rhs);
+                  ESVO rhs_part, const std::string rhs,
+                  double weight = 1.0);
+
+    /*!
+     * \brief Compile the grammar into its read-only generation form.
+     *
+     * All keys and phrases are interned into integer identifiers, and the
+     * dictionary and rules are laid out in contiguous arrays per part of
+     * sentence. Sentences are generated from the compiled form only.
+     *
+     * Adding symbols or rules marks the compiled form out of date. It is
+     * recompiled, if needed, on the next sentence generation.
+     */
+    void compile();
+
+    /*!
+     * \brief Save the compiled grammar to a binary file.
+     *
+     * The file is a relocatable image of the compiled tables: string pool,
+     * per part dictionaries, rules, and alias tables. It is written to a
+     * temporary file and then renamed, so processes using the old file are
+     * not disturbed.
+     *
+     * \param path  File path.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool save_compiled(const std::string &path);
+
+    /*!
+     * \brief Load a compiled grammar saved by save_compiled.
+     *
+     * The file is memory mapped read-only and used in place with no parsing,
+     * so many processes share one copy of its pages. The loaded grammar
+     * replaces this grammar, including its language name. It has no text
+     * form to print, and symbols or rules added afterwards start a new grammar.
+     *
+     * \param path  File path.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool load_compiled(const std::string &path);
+
+    /*!
+     * \brief Load compiled grammar tables.
+     *
+     * The tables are used in place with no parsing and no copying, so a
+     * grammar generated into constant tables at build time is ready with no
+     * tables built on the heap. The loaded grammar replaces this grammar, including
+     * its language name. It has no text form to print, and symbols or rules
+     * added afterwards start a new grammar. The tables must outlive their use
+     * by the grammar.
+     *
+     * \param tables  Compiled grammar tables.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool load_tables(const Tables &tables);
+
+    /*!
+     * \brief Get the compiled grammar.
+     *
+     * The grammar is compiled, if needed. The view is valid until the grammar
+     * is next compiled or loaded.
+     *
+     * \return Returns reference to the read-only compiled grammar.
+     */
+    const GrammarView &compiled();
 
     /*!
      * \brief Generate random sentence within the grammar.
@@ -211,6 +403,102 @@ namespace clan
      */
     std::string random_sentence();
 
+    /*!
+     * \brief Generate random sentence within the grammar into a buffer.
+     *
+     * The buffer's capacity is reused, so generating into the same buffer
+     * does not allocate once it has grown to the longest sentence.
+     *
+     * \param [out] sentence  Sentence buffer.
+     */
+    void random_sentence(std::string &sentence);
+
+    /*!
+     * \brief Generate a batch of random sentences in parallel.
+     *
+     * Sentences are generated from the read only compiled grammar. Sentence i
+     * draws from its own random number stream of (seed, first + i), so the
+     * batch is reproducible for a seed regardless of the number of threads, and
+     * consecutive batches of a seed (first = 0, n, 2n, ...) continue one
+     * reproducible sequence.
+     *
+     * The grammar must not be modified while generating.
+     *
+     * \param n           Number of sentences to generate.
+     * \param seed        Random number seed.
+     * \param threads     Number of threads. If 0, then one per hardware core.
+     * \param [out] sentences Caller's buffer. Resized to n sentences. The
+     *                        capacity of its strings is reused.
+     * \param first       Sequence number of the first sentence of the batch.
+     */
+    void generate_batch(size_t n,
+                        uint64_t seed,
+                        unsigned threads,
+                        StrVec &sentences,
+                        uint64_t first = 0);
+
+    /*!
+     * \brief Generate random coded sentence within the grammar.
+     *
+     * \param [out] sentence  Coded sentence.
+     * \param subject         Subject phrase the sentence starts with. If
+     *                        NoPhrase, then the subject is chosen at random.
+     */
+    void random_sentence(CodedSentence &sentence, PhraseId subject = NoPhrase);
+
+    /*!
+     * \brief Generate a batch of random coded sentences in parallel.
+     *
+     * Sentence i starts with subject phrase subjects[i] and draws from the
+     * same random number stream of (seed, first + i) as generate_batch of
+     * text sentences. Its k'th phrase is written to column phrases[k][i],
+     * NoPhrase past its end. Columns that are nullptr are not written.
+     *
+     * The grammar must not be modified while generating.
+     *
+     * \param n           Number of sentences to generate.
+     * \param subjects    Subject phrases of the sentences. If nullptr, then
+     *                    subjects are chosen at random.
+     * \param seed        Random number seed.
+     * \param threads     Number of threads. If 0, then one per hardware core.
+     * \param phrases     Output columns of n phrase identifiers per sentence
+     *                    position.
+     * \param first       Sequence number of the first sentence of the batch.
+     */
+    void generate_batch(size_t n,
+                        const PhraseId *subjects,
+                        uint64_t seed,
+                        unsigned threads,
+                        PhraseId *const phrases[NUMOF_ESVOS],
+                        uint64_t first = 0);
+
+    /*!
+     * \brief Find a phrase in a part's dictionary of the compiled grammar.
+     *
+     * \param part    Part of sentence.
+     * \param phrase  Phrase.
+     *
+     * \return Returns phrase identifier, NoPhrase if not found.
+     */
+    PhraseId phrase_id(ESVO part, std::string_view phrase);
+
+    /*!
+     * \brief Get phrase of the compiled grammar.
+     *
+     * \param id  Phrase identifier.
+     *
+     * \return Returns phrase, empty if id is not a phrase identifier.
+     */
+    std::string_view phrase(PhraseId id) const;
+
+    /*!
+     * \brief Decode coded sentence into text.
+     *
+     * \param coded           Coded sentence.
+     * \param [out] sentence  Sentence buffer. Its capacity is reused.
+     */
+    void decode(const CodedSentence &coded, std::string &sentence) const;
+
     /*!
      * \brief Print out grammar symbols.
      */
@@ -240,6 +528,203 @@ namespace clan
     std::unique_ptr<Impl> pimpl;    ///< private implementation
   };
 
+  /*!
+   * \brief Read-only grammar view of compiled grammar tables.
+   *
+   * A view generates sentences from the compiled tables in place, with no
+   * private implementation, so a view of constant tables generated at build
+   * time is made with no allocation. The compiled form of a Grammar is a
+   * view, too (see Grammar::compiled).
+   *
+   * A view is read only, so any number of threads may generate concurrently.
+   * Sentence i of a seed draws from its own random number stream of
+   * (seed, i), the same stream as sentence i of Grammar::generate_batch.
+   * Nothing is allocated once a caller's scratch and sentence buffers have
+   * grown to fit.
+   */
+  class GrammarView : public Grammar::Tables
+  {
+  public:
+    typedef uint32_t                Id;       ///< string identifier or index
+    typedef std::vector<Id>         IdVec;    ///< vector of identifiers
+    typedef Grammar::Production     Production;     ///< rule production
+    typedef Grammar::PhraseId       PhraseId;       ///< phrase identifier
+    typedef Grammar::CodedSentence  CodedSentence;  ///< coded sentence
+
+    /*!
+     * \brief Default constructor. The view is empty.
+     */
+    GrammarView()
+    {
+    }
+
+    /*!
+     * \brief Compiled tables constructor.
+     *
+     * \copydetails load_tables
+     *
+     * \param tables  Compiled grammar tables.
+     */
+    explicit GrammarView(const Grammar::Tables &tables);
+
+    /*!
+     * \brief View compiled grammar tables.
+     *
+     * The tables are used in place with no parsing, no copying, and no
+     * allocation. They are validated once. On failure, the view is empty. The
+     * tables must outlive their use by the view.
+     *
+     * \param tables  Compiled grammar tables.
+     *
+     * \return Returns true on success, false otherwise.
+     */
+    bool load_tables(const Grammar::Tables &tables);
+
+    /*!
+     * \brief Get language name.
+     */
+    std::string_view language() const
+    {
+      return std::string_view(lang.data(), lang.size());
+    }
+
+    /*!
+     * \brief Generate random sentence into a buffer.
+     *
+     * \param seed            Random number seed.
+     * \param i               Random number stream of the seed.
+     * \param [in,out] keys   Scratch buffer.
+     * \param [out] sentence  Sentence buffer. Its capacity is reused.
+     */
+    void random_sentence(uint64_t seed, uint64_t i, IdVec &keys,
+                         std::string &sentence) const;
+
+    /*!
+     * \brief Generate random coded sentence.
+     *
+     * \param seed            Random number seed.
+     * \param i               Random number stream of the seed.
+     * \param [in,out] keys   Scratch buffer.
+     * \param [out] sentence  Coded sentence.
+     * \param subject         Subject phrase the sentence starts with. If
+     *                        NoPhrase, then the subject is chosen at random.
+     */
+    void random_sentence(uint64_t seed, uint64_t i, IdVec &keys,
+                         CodedSentence &sentence,
+                         PhraseId subject = Grammar::NoPhrase) const;
+
+    /*!
+     * \copydoc Grammar::generate_batch(size_t, uint64_t, unsigned, StrVec &,
+     * uint64_t)
+     */
+    void generate_batch(size_t n,
+                        uint64_t seed,
+                        unsigned threads,
+                        StrVec &sentences,
+                        uint64_t first = 0) const;
+
+    /*!
+     * \copydoc Grammar::generate_batch(size_t, const PhraseId *, uint64_t,
+     * unsigned, PhraseId *const[], uint64_t)
+     */
+    void generate_batch(size_t n,
+                        const PhraseId *subjects,
+                        uint64_t seed,
+                        unsigned threads,
+                        PhraseId *const phrases[Grammar::NUMOF_ESVOS],
+                        uint64_t first = 0) const;
+
+    /*!
+     * \brief Find a phrase in a part's dictionary.
+     *
+     * \param part    Part of sentence.
+     * \param phrase  Phrase.
+     *
+     * \return Returns phrase identifier, NoPhrase if not found.
+     */
+    PhraseId phrase_id(Grammar::ESVO part, std::string_view phrase) const;
+
+    /*!
+     * \copydoc Grammar::phrase
+     */
+    std::string_view phrase(PhraseId id) const;
+
+    /*!
+     * \copydoc Grammar::decode
+     */
+    void decode(const CodedSentence &coded, std::string &sentence) const;
+
+  protected:
+    /*!
+     * \brief Use tables in place.
+     *
+     * \param tables  Compiled grammar tables.
+     *
+     * \return Returns nullptr on success, an error message otherwise.
+     */
+    const char *attach(const Grammar::Tables &tables);
+
+    /*!
+     * \brief Check that the table sizes agree and that every table element
+     * indexes within its target table.
+     */
+    bool consistent() const;
+
+    /*!
+     * \brief Interned string.
+     *
+     * \param id    String identifier.
+     */
+    std::string_view string(Id id) const
+    {
+      return std::string_view(pool.data() + str_off[id],
+                              str_off[id+1] - str_off[id]);
+    }
+
+    /*!
+     * \brief Find the keys of a part's dictionary containing a phrase.
+     *
+     * \param part          Part of sentence.
+     * \param phrase        Phrase string identifier.
+     * \param [out] keys    Key indices.
+     *
+     * \return Number of keys found.
+     */
+    size_t find_keys_with_phrase(Grammar::ESVO part, Id phrase,
+                                 IdVec &keys) const;
+
+    /*!
+     * \brief Number of productions of rule.
+     *
+     * \param rule  Rule left hand side string identifier.
+     */
+    Id num_prods(Id rule) const
+    {
+      return rule + 1 < rule_off.size()? rule_off[rule+1] - rule_off[rule]: 0;
+    }
+
+    /*!
+     * \brief Generate random sentence phrase by phrase.
+     *
+     * A sentence is a chain: the subject phrase fires a rule of a key
+     * containing it, whose production selects the key of the next phrase, and
+     * so on up to one phrase per part of sentence. The chain is built by
+     * iteration, and nothing is allocated once the scratch buffer has grown to
+     * the largest number of keys containing one phrase.
+     *
+     * \param seed          Random number seed.
+     * \param i             Random number stream of the seed.
+     * \param [in,out] keys Scratch buffer.
+     * \param emit          Callback emit(part, phrase) for each phrase in
+     *                      sentence order.
+     * \param subject       Subject phrase to start with. If NoPhrase, then
+     *                      the subject is chosen at random.
+     */
+    template<typename Emit>
+    void random_phrases(uint64_t seed, uint64_t i, IdVec &keys, Emit &&emit,
+                        Id subject) const;
+  };
+
 } // namespace clan
 
 #endif // _CLAN_GRAMMAR_H
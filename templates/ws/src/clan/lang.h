@@ -28,7 +28,26 @@ namespace clan
 
   namespace troglodese
   {
-    extern Language Troglodese;
+    /*!
+     * \brief The static component of the Troglodese language in text form.
+     *
+     * The text form is made on first use, so programs using only the
+     * compiled tables do not build it at static initialization.
+     *
+     * \return Returns reference to the language.
+     *
+     * \sa clan::Grammar::load
+     */
+    extern const Language &language();
+
+    /*!
+     * \brief The compiled static component of the Troglodese language.
+     *
+     * Constant tables generated at build time from troglodese.lang.
+     *
+     * \sa clan::GrammarView::load_tables
+     */
+    extern const Grammar::Tables TroglodeseTables;
 
     /*!
      * \brief Add stone tool grammar components to the language.
@@ -0,0 +1,657 @@
+#!/usr/bin/env python3
+#
+# File:
+#   langgen.py
+#
+# Usage:
+#   langgen.py [OPTIONS] LANG_FILE
+#   langgen.py --help
+#
+# Description:
+#   Compile a clan language definition file into a C++ header of constexpr
+#   grammar tables, written to stdout. A clan::Grammar is constructed from the
+#   tables with no parsing.
+#
+# \LegalBegin
+# \LegalEnd
+#
+
+import sys
+import os
+import struct
+import getopt
+
+# parts of sentence in clan::Grammar::ESVO order
+Parts     = 'svop'
+PartNames = ['Subject', 'Verb', 'Object', 'Pvp']
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+class LangError(Exception):
+  """ Language Definition Error Exception Class. """
+  def __init__(self, line, col, msg):
+    self.line = line
+    self.col  = col
+    self.msg  = msg
+
+# -----------------------------------------------------------------------------
+class Statement:
+  """ Coded symbol or rule, possibly continued over several lines. """
+
+  def __init__(self, line, col, text):
+    self.text     = text
+    self.segments = [(0, line, col)]  # (text offset, line, column) of lines
+
+  def append(self, line, col, text):
+    self.text += ' '
+    self.segments.append((len(self.text), line, col))
+    self.text += text
+
+  def where(self, pos):
+    """ Line and column of a position in the statement text. """
+    for off, line, col in reversed(self.segments):
+      if pos >= off:
+        return line, col + pos - off
+    return self.segments[0][1], self.segments[0][2]
+
+  def unbalanced(self):
+    return self.text.count('[') > self.text.count(']')
+
+# -----------------------------------------------------------------------------
+class Parser:
+  """
+  Parser of the coded symbol and rule syntax documented with
+  clan::Grammar::load. It accepts exactly what the C++ parser accepts.
+  """
+
+  def __init__(self, stmt):
+    self.stmt = stmt
+    self.text = stmt.text
+    self.pos  = 0
+
+  def symbol(self):
+    """ Parse symbol. Return (part, (key, weight), [(phrase, weight),...]). """
+    part, key = self.part_phrase()
+    phrases = []
+    self.skip_space()
+    if self.peek() == '[':
+      if key[1] != 1.0:
+        self.error("a phrase group is weighted by its phrases")
+      self.pos += 1
+      while True:
+        self.skip_space()
+        # trailing comma
+        if self.peek() == ']' and phrases:
+          break
+        phrases.append(self.phrase())
+        self.skip_space()
+        if not self.accept(','):
+          break
+      self.expect(']', "expected ',' or ']'")
+    self.end()
+    return part, key, phrases
+
+  def rule(self):
+    """ Parse rule. Return (lhs_part, lhs, rhs_part, rhs, weight). """
+    lhs_part, lhs = self.part_phrase()
+    if lhs[1] != 1.0:
+      self.error("expected '->' before weight")
+    self.skip_space()
+    self.expect('-', "expected '->'")
+    self.expect('>', "expected '->'")
+    rhs_part, rhs = self.part_phrase()
+    self.end()
+    return lhs_part, lhs[0], rhs_part, rhs[0], rhs[1]
+
+  def part_phrase(self):
+    self.skip_space()
+    part = Parts.find(self.peek()) if self.peek() else -1
+    if part < 0:
+      self.error("expected part of sentence 's', 'v', 'o', or 'p'")
+    self.pos += 1
+    self.expect(':', "expected ':' after part of sentence")
+    return part, self.phrase()
+
+  def phrase(self):
+    self.skip_space()
+    start = end = self.pos
+    while self.pos < len(self.text) and self.is_phrase_char(self.text[self.pos]):
+      self.pos += 1
+      if self.text[self.pos-1] != ' ':
+        end = self.pos
+    if end == start:
+      self.pos = start
+      self.error("expected phrase")
+    text = self.text[start:end]
+    return (text, self.weight()) if self.accept('@') else (text, 1.0)
+
+  def weight(self):
+    # same arithmetic as the C++ parser for identical weights
+    w, frac, digit = 0.0, 0.1, False
+    self.skip_space()
+    while self.is_digit(self.peek()):
+      w = w * 10.0 + (ord(self.text[self.pos]) - ord('0'))
+      self.pos += 1
+      digit = True
+    if self.accept('.'):
+      digit = False
+      while self.is_digit(self.peek()):
+        w += frac * (ord(self.text[self.pos]) - ord('0'))
+        self.pos += 1
+        frac *= 0.1
+        digit = True
+    if not digit:
+      self.error("expected weight number")
+    return w
+
+  def end(self):
+    self.skip_space()
+    if self.pos != len(self.text):
+      self.error("unexpected character")
+
+  def accept(self, c):
+    self.skip_space()
+    if self.peek() == c:
+      self.pos += 1
+      return True
+    return False
+
+  def expect(self, c, emsg):
+    if not self.accept(c):
+      self.error(emsg)
+
+  def peek(self):
+    return self.text[self.pos] if self.pos < len(self.text) else ''
+
+  def skip_space(self):
+    while self.pos < len(self.text) and self.text[self.pos] == ' ':
+      self.pos += 1
+
+  def error(self, emsg):
+    line, col = self.stmt.where(self.pos)
+    raise LangError(line, col, emsg)
+
+  @staticmethod
+  def is_digit(c):
+    return c != '' and c in '0123456789'
+
+  @staticmethod
+  def is_phrase_char(c):
+    return c.isascii() and (c.isalnum() or c in '_ ')
+
+# -----------------------------------------------------------------------------
+def f32(x):
+  """ Round to single precision. """
+  return struct.unpack('f', struct.pack('f', x))[0]
+
+def alias_table(weights):
+  """
+  Walker/Vose alias table of relative weights, built exactly as
+  clan::AliasTable::build builds it.
+
+  Return:
+    (prob, alias) lists.
+  """
+  n = len(weights)
+  total = 0.0
+  for w in weights:
+    total += w if w > 0.0 else 0.0
+  p, small, large = [], [], []
+  for i in range(n):
+    p.append((weights[i] if weights[i] > 0.0 else 0.0) * n / total \
+              if total > 0.0 else 1.0)
+    (small if p[i] < 1.0 else large).append(i)
+  prob  = [1.0] * n
+  alias = list(range(n))
+  while small and large:
+    s = small.pop()
+    l = large.pop()
+    prob[s]  = f32(p[s])
+    alias[s] = l
+    p[l] = (p[l] + p[s]) - 1.0
+    (small if p[l] < 1.0 else large).append(l)
+  return prob, alias
+
+def weight_sum(weights):
+  """ Sum of weights, added in order. """
+  total = 0.0
+  for w in weights:
+    total += w
+  return total
+
+# -----------------------------------------------------------------------------
+class LangGrammar:
+  """
+  Text form of a grammar with the semantics of clan::Grammar, compiled into
+  the same tables as clan::Grammar::compile.
+  """
+
+  def __init__(self):
+    self.dict        = [{} for p in Parts]   # key -> phrases
+    self.phrase_keys = [{} for p in Parts]   # phrase -> keys containing it
+    self.weights     = [{} for p in Parts]   # key -> phrase weights
+    self.rules       = {}                    # lhs -> [(part, rhs, weight),...]
+
+  def add_symbol(self, part, phrase, weight):
+    """ Add terminal phrase. """
+    if phrase in self.dict[part]:
+      # replaced phrases no longer index the key
+      self.unindex(part, phrase, self.dict[part][phrase])
+    self.dict[part][phrase] = [phrase]
+    self.index(part, phrase, [phrase])
+    self.weights[part][phrase] = [weight]
+
+  def add_group(self, part, key, phrases, weights):
+    """ Add non-terminal group of terminal phrases. """
+    if key not in self.dict[part]:
+      self.dict[part][key]    = list(phrases)
+      self.weights[part][key] = list(weights)
+    else:
+      self.dict[part][key]    += phrases
+      self.weights[part][key] += weights
+    self.index(part, key, phrases)
+    for phrase, weight in zip(phrases, weights):
+      self.add_symbol(part, phrase, weight)
+
+  def add_rule(self, lhs_part, lhs, rhs_part, rhs, weight):
+    """ Add production rule. Return error message or None. """
+    if lhs not in self.dict[lhs_part]:
+      return f"{PartNames[lhs_part].upper()} '{lhs}' not found"
+    elif rhs not in self.dict[rhs_part]:
+      return f"{PartNames[rhs_part].upper()} '{rhs}' not found"
+    self.rules.setdefault(lhs, []).append((rhs_part, rhs, weight))
+    return None
+
+  def index(self, part, key, phrases):
+    for phrase in phrases:
+      keys = self.phrase_keys[part].setdefault(phrase, [])
+      if key not in keys:
+        keys.append(key)
+
+  def unindex(self, part, key, phrases):
+    for phrase in phrases:
+      keys = self.phrase_keys[part].get(phrase)
+      if keys is not None:
+        keys[:] = [k for k in keys if k != key]
+        if not keys:
+          del self.phrase_keys[part][phrase]
+
+  def compile(self):
+    """
+    Compile into interned tables in the clan::Grammar::compile order.
+
+    Return:
+      Dictionary of tables.
+    """
+    ids     = {}
+    strings = []
+    keyidx  = [{} for p in Parts]
+
+    def intern(s):
+      if s not in ids:
+        ids[s] = len(strings)
+        strings.append(s)
+      return ids[s]
+
+    # std::map order
+    ordered = lambda d: sorted(d, key=lambda s: s.encode())
+
+    parts = []
+    for part in range(len(Parts)):
+      t = {'key_str': [], 'key_off': [0], 'phrases': [], 'phrase_prob': [],
+           'phrase_alias': []}
+      key_weights = []
+      for key in ordered(self.dict[part]):
+        kid = intern(key)
+        keyidx[part][kid] = len(t['key_str'])
+        t['key_str'].append(kid)
+        for phrase in self.dict[part][key]:
+          t['phrases'].append(intern(phrase))
+        t['key_off'].append(len(t['phrases']))
+        prob, alias = alias_table(self.weights[part][key])
+        t['phrase_prob']  += prob
+        t['phrase_alias'] += alias
+        key_weights.append(weight_sum(self.weights[part][key]))
+      t['key_prob'], t['key_alias'] = alias_table(key_weights)
+      parts.append(t)
+
+    # inverted phrase index, ordered by phrase string identifier
+    for part in range(len(Parts)):
+      t = parts[part]
+      inv_off = [0] * (len(strings) + 1)
+      for phrase, keys in self.phrase_keys[part].items():
+        inv_off[ids[phrase] + 1] = len(keys)
+      for i in range(1, len(inv_off)):
+        inv_off[i] += inv_off[i-1]
+      inv_keys = [0] * inv_off[-1]
+      for phrase, keys in self.phrase_keys[part].items():
+        pos = inv_off[ids[phrase]]
+        for key in keys:
+          inv_keys[pos] = keyidx[part][ids[key]]
+          pos += 1
+      t['inv_off']  = inv_off
+      t['inv_keys'] = inv_keys
+
+    # rules, ordered by left hand side string identifier
+    rule_off = [0] * (len(strings) + 1)
+    for lhs in ordered(self.rules):
+      rule_off[intern(lhs) + 1] = len(self.rules[lhs])
+    for i in range(1, len(rule_off)):
+      rule_off[i] += rule_off[i-1]
+    prods      = [None] * rule_off[-1]
+    prod_prob  = [0.0] * rule_off[-1]
+    prod_alias = [0] * rule_off[-1]
+    for lhs in ordered(self.rules):
+      pos = rule_off[intern(lhs)]
+      prob, alias = alias_table([w for _, _, w in self.rules[lhs]])
+      for i, (part, rhs, _) in enumerate(self.rules[lhs]):
+        prods[pos]      = (part, keyidx[part][intern(rhs)])
+        prod_prob[pos]  = prob[i]
+        prod_alias[pos] = alias[i]
+        pos += 1
+
+    str_off = [0]
+    for s in strings:
+      str_off.append(str_off[-1] + len(s))
+
+    return {'strings': strings, 'str_off': str_off, 'parts': parts,
+            'rule_off': rule_off, 'prods': prods, 'prod_prob': prod_prob,
+            'prod_alias': prod_alias}
+
+# -----------------------------------------------------------------------------
+class LangGen:
+  """ Language definition to C++ tables generator class. """
+
+  def read_lang(self, path):
+    """ Read language definition file into name, symbols, and rules. """
+    name, section = None, None
+    stmts = {'symbols': [], 'rules': []}
+    stmt  = None
+    with open(path) as fp:
+      for n, line in enumerate(fp, start=1):
+        line = line.split('#', 1)[0].rstrip()
+        text = line.lstrip(' \t')
+        col  = len(line) - len(text) + 1
+        if not text:
+          continue
+        elif stmt is not None and stmt.unbalanced():
+          stmt.append(n, col, text)
+          continue
+        stmt = None
+        if text.startswith('%'):
+          words = text[1:].split()
+          if words[:1] == ['language'] and len(words) == 2 and \
+              words[1].isidentifier():
+            name = words[1]
+          elif words in (['symbols'], ['rules']):
+            section = words[0]
+          else:
+            raise LangError(n, col, f"bad directive '{text}'")
+        elif section is None:
+          raise LangError(n, col, "expected '%symbols' or '%rules'")
+        else:
+          stmt = Statement(n, col, text)
+          stmts[section].append(stmt)
+    if name is None:
+      raise LangError(1, 1, "no '%language NAME'")
+    elif not stmts['symbols'] or not stmts['rules']:
+      raise LangError(1, 1, "no symbols or no rules")
+    return name, stmts['symbols'], stmts['rules']
+
+  def build(self, symbols, rules):
+    """ Build grammar from parsed statements. """
+    g = LangGrammar()
+    for stmt in symbols:
+      part, key, phrases = Parser(stmt).symbol()
+      if not phrases:
+        g.add_symbol(part, key[0], key[1])
+      else:
+        g.add_group(part, key[0], [p for p, _ in phrases],
+                                  [w for _, w in phrases])
+    for stmt in rules:
+      emsg = g.add_rule(*Parser(stmt).rule())
+      if emsg:
+        line, col = stmt.where(0)
+        raise LangError(line, col, emsg)
+    return g
+
+  def emit(self, name, symbols, rules, tables):
+    """ Write C++ header to stdout. """
+    ns      = self.kwargs['namespace'].split('::')
+    base    = os.path.splitext(os.path.basename(self.kwargs['lang_file']))[0]
+    guard   = f"_{ns[0]}_{base}_lang_h".upper()
+    indent  = '  ' * len(ns)
+    out     = []
+
+    def quote(s):
+      return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+    def array(ident, ctype, values, fmt=str, wrap=True):
+      if not values:
+        return
+      sep = '' if ctype.endswith('*') else ' '
+      out.append(f"{indent}constexpr {ctype}{sep}{ident}[] =")
+      out.append(f"{indent}{{")
+      items = [fmt(v) for v in values]
+      line  = indent + '  '
+      for i, item in enumerate(items):
+        item += ',' if i + 1 < len(items) else ''
+        if (not wrap or len(line) + len(item) + 1 > 80) and line.strip():
+          out.append(line.rstrip())
+          line = indent + '  '
+        line += item + ' '
+      out.append(line.rstrip())
+      out.append(f"{indent}}};")
+      out.append('')
+
+    def real(v):
+      s = format(v, '.9g')
+      return (s if '.' in s or 'e' in s else s + '.0') + 'f'
+
+    def table(ident, values):
+      return f"{{{ident}, {len(values)}}}" if values else "{nullptr, 0}"
+
+    out.append(f"""\
+/*! \\file
+ *
+ * \\brief {name} language compiled grammar tables.
+ *
+ * Generated by langgen.py from {os.path.basename(self.kwargs['lang_file'])}.
+ * Do not edit.
+ */
+
+#ifndef {guard}
+#define {guard}
+
+#include <cstdint>
+
+#include "grammar.h"
+""")
+    for i, n in enumerate(ns):
+      out.append(f"{'  ' * i}namespace {n}")
+      out.append(f"{'  ' * i}{{")
+
+    out.append(f"{indent}/*! {name} language name. */")
+    out.append(f"{indent}constexpr char {name}Lang[] = {quote(name)};")
+    out.append('')
+    out.append(f"{indent}/*! {name} coded symbols. */")
+    array(f"{name}Symbols", 'const char *', [s.text for s in symbols], quote,
+          False)
+    out.append(f"{indent}/*! {name} coded rules. */")
+    array(f"{name}Rules", 'const char *', [r.text for r in rules], quote,
+          False)
+
+    out.append(f"{indent}/*! {name} interned strings. */")
+    if tables['strings']:
+      out.append(f"{indent}constexpr char {name}Pool[] =")
+      for i, s in enumerate(tables['strings']):
+        end = ';' if i + 1 == len(tables['strings']) else ''
+        out.append(f"{indent}  {quote(s)}{end}")
+      out.append('')
+    array(f"{name}StrOff", 'uint32_t', tables['str_off'])
+
+    fields = [('key_str', 'KeyStr', 'uint32_t', str),
+              ('key_off', 'KeyOff', 'uint32_t', str),
+              ('phrases', 'Phrases', 'uint32_t', str),
+              ('inv_off', 'InvOff', 'uint32_t', str),
+              ('inv_keys', 'InvKeys', 'uint32_t', str),
+              ('phrase_prob', 'PhraseProb', 'float', real),
+              ('phrase_alias', 'PhraseAlias', 'uint32_t', str),
+              ('key_prob', 'KeyProb', 'float', real),
+              ('key_alias', 'KeyAlias', 'uint32_t', str)]
+
+    for part, t in zip(PartNames, tables['parts']):
+      out.append(f"{indent}/*! {name} {part.lower()} dictionary. */")
+      for field, suffix, ctype, fmt in fields:
+        array(f"{name}{part}{suffix}", ctype, t[field], fmt)
+
+    out.append(f"{indent}/*! {name} rules. */")
+    array(f"{name}RuleOff", 'uint32_t', tables['rule_off'])
+    array(f"{name}Prods", 'Grammar::Production', tables['prods'],
+          lambda p: f"{{{p[0]}, {p[1]}}}")
+    array(f"{name}ProdProb", 'float', tables['prod_prob'], real)
+    array(f"{name}ProdAlias", 'uint32_t', tables['prod_alias'])
+
+    pool  = ''.join(tables['strings'])
+    parts = [[table(f"{name}{part}{suffix}", t[field]) \
+                for field, suffix, _, _ in fields] \
+                  for part, t in zip(PartNames, tables['parts'])]
+    members = [table(f"{name}Lang", name),
+               table(f"{name}Pool", pool),
+               table(f"{name}StrOff", tables['str_off']),
+               parts,
+               table(f"{name}RuleOff", tables['rule_off']),
+               table(f"{name}Prods", tables['prods']),
+               table(f"{name}ProdProb", tables['prod_prob']),
+               table(f"{name}ProdAlias", tables['prod_alias'])]
+
+    # brace enclosed initializer, one table per line
+    def init(items, ind, end):
+      out.append(f"{ind}{{")
+      for i, m in enumerate(items):
+        sep = ',' if i + 1 < len(items) else ''
+        if isinstance(m, str):
+          out.append(f"{ind}  {m}{sep}")
+        else:
+          init(m, ind + '  ', sep)
+      out.append(f"{ind}}}{end}")
+
+    out.append(f"{indent}/*! {name} compiled grammar tables. */")
+    out.append(f"{indent}constexpr Grammar::Tables {name}Tables =")
+    init(members, indent, ';')
+
+    for i in reversed(range(len(ns))):
+      out.append('')
+      out.append(f"{'  ' * i}}} // namespace {ns[i]}")
+
+    out.append('')
+    out.append(f"#endif // {guard}")
+
+    sys.stdout.write('\n'.join(out) + '\n')
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}", file=sys.stderr)
+    else:
+      print(f"{self.argv0}: error", file=sys.stderr)
+    print(f"Try '{self.argv0} --help' for more information.", file=sys.stderr)
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] LANG_FILE
+       {self.argv0} --help
+
+Compile a clan language definition file into a C++ header of constexpr grammar
+tables, written to stdout.
+
+Options:
+      --namespace=NS    C++ namespace of the tables. Default: clan
+
+  -h, --help            Display this help and exit.
+
+Description:
+LANG_FILE
+Language definition file:
+  %language NAME      language name, also the prefix of the table names
+  %symbols            coded symbols follow, one per line
+  %rules              coded rules follow, one per line
+The coded symbol and rule syntax is that of clan::Grammar::load. A phrase list
+may continue on the following lines until its closing ']'. Comments start with
+'#'.
+
+The header defines NAMELang, NAMESymbols, and NAMERules, the language as coded
+text, and NAMETables, the grammar compiled exactly as clan::Grammar::compile
+compiles the coded text.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    # option defaults
+    kwargs = {}
+    kwargs['namespace'] = 'clan'
+
+    shortopts = "?h"
+    longopts  = ['help', 'namespace=']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--namespace',):
+          if not all(n.isidentifier() for n in optarg.split('::')):
+            raise UsageError(f"'{optarg}': Bad namespace.")
+          kwargs['namespace'] = optarg
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No LANG_FILE specified")
+      sys.exit(2)
+    else:
+      kwargs['lang_file'] = args[0]
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    path = self.kwargs['lang_file']
+
+    try:
+      name, symbols, rules = self.read_lang(path)
+      g = self.build(symbols, rules)
+    except OSError as e:
+      print(f"{self.argv0}: {path}: {e.strerror}", file=sys.stderr)
+      return 8
+    except LangError as e:
+      print(f"{path}:{e.line}:{e.col}: error: {e.msg}", file=sys.stderr)
+      return 8
+
+    self.emit(name, symbols, rules, g.compile())
+
+    return 0
+
+
+# -----------------------------------------------------------------------------
+app = LangGen()
+sys.exit( app.main(sys.argv) )
@@ -0,0 +1,129 @@
+/*! \file
+ *
+ * \brief Troglodyte population class implementation.
+ *
+ * \pkgfile{@FILENAME@}
+ * \pkgcomponent{Application,clan}
+ * \author @PKG_AUTHOR@
+ *
+ * \LegalBegin
+ * @PKG_LICENSE@
+ * \LegalEnd
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "utils.h"
+#include "troglodyte.h"
+#include "grammar.h"
+#include "population.h"
+
+namespace clan
+{
+  Population::Population()
+  {
+    clear();
+  }
+
+  void Population::reserve(size_t n)
+  {
+    m_name.reserve(n);
+    m_sex.reserve(n);
+    m_age.reserve(n);
+    m_moon.reserve(n);
+    m_subject.reserve(n);
+
+    for(int k = 0; k < ActivityLen; ++k)
+    {
+      m_activity[k].reserve(n);
+    }
+  }
+
+  void Population::clear()
+  {
+    m_names.clear();
+    m_pool.clear();
+    m_name_off.assign(1, 0);
+
+    m_name.clear();
+    m_sex.clear();
+    m_age.clear();
+    m_moon.clear();
+    m_subject.clear();
+
+    for(int k = 0; k < ActivityLen; ++k)
+    {
+      m_activity[k].clear();
+    }
+  }
+
+  Population::Id Population::add(std::string_view name,
+                                 Troglodyte::Sex  sex,
+                                 int              age,
+                                 FullMoon         birth_moon,
+                                 PhraseId         subject)
+  {
+    size_t  n = m_names.find(name);
+
+    // intern new name
+    if( n == PrefixTrie::npos )
+    {
+      n = num_names();
+      m_names.insert(std::string(name), n);
+      m_pool.append(name);
+      m_name_off.push_back((uint32_t)m_pool.size());
+    }
+
+    m_name.push_back((NameId)n);
+    m_sex.push_back((uint8_t)sex);
+    m_age.push_back((uint8_t)std::clamp(age, 0, 255));
+    m_moon.push_back((uint8_t)birth_moon);
+    m_subject.push_back(subject);
+
+    for(int k = 0; k < ActivityLen; ++k)
+    {
+      m_activity[k].push_back(Grammar::NoPhrase);
+    }
+
+    return (Id)(size() - 1);
+  }
+
+  void Population::update(const GrammarView &grammar, uint64_t seed,
+                          unsigned threads, uint64_t step)
+  {
+    PhraseId *phrases[Grammar::NUMOF_ESVOS] = {nullptr};
+
+    // the subject is not stored
+    for(int k = 0; k < ActivityLen; ++k)
+    {
+      phrases[k+1] = m_activity[k].data();
+    }
+
+    grammar.generate_batch(size(), m_subject.data(), seed, threads, phrases,
+                           step * size());
+  }
+
+  void Population::whatcha_doin(Id i, const GrammarView &grammar,
+                                std::string &doin) const
+  {
+    doin.assign(name(i));
+
+    if( is_idle(i) )
+    {
+      doin.append(" me doin' nothin'");
+      return;
+    }
+
+    for(int k = 0; k < ActivityLen && m_activity[k][i] != Grammar::NoPhrase;
+        ++k)
+    {
+      doin += ' ';
+      doin.append(grammar.phrase(m_activity[k][i]));
+    }
+  }
+
+} // namespace clan
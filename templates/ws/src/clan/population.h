@@ -0,0 +1,297 @@
+/*! \file
+ *
+ * \brief Troglodyte population class interface.
+ *
+ * \pkgfile{@FILENAME@}
+ * \pkgcomponent{Application,clan}
+ * \author @PKG_AUTHOR@
+ *
+ * \LegalBegin
+ * @PKG_LICENSE@
+ * \LegalEnd
+ */
+
+#ifndef _CLAN_POPULATION_H
+#define _CLAN_POPULATION_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include "utils.h"
+#include "troglodyte.h"
+#include "grammar.h"
+
+namespace clan
+{
+  /*!
+   * \brief Population of troglodytes stored as structure of arrays.
+   *
+   * Each member attribute is a column indexed by member identifier. Names are
+   * interned into one string pool, so members of the same name share it. Sex,
+   * age, and birth moon are byte columns.
+   *
+   * A member's activities are generated from the compiled grammar starting
+   * with the member's subject phrase: its own name, if the grammar has it, or
+   * a stand-in such as "Trog". The current activity is the rest of the coded
+   * sentence, one column of grammar phrase identifiers per sentence position.
+   * An idle member has no activity.
+   */
+  class Population
+  {
+  public:
+    typedef uint32_t          Id;       ///< member identifier
+    typedef uint32_t          NameId;   ///< interned name identifier
+    typedef Grammar::PhraseId PhraseId; ///< grammar phrase identifier
+
+    /*! Number of activity phrases (sentence positions after the subject). */
+    static const int ActivityLen = Grammar::NUMOF_ESVOS - 1;
+
+    /*!
+     * \brief Default constructor.
+     */
+    Population();
+
+    /*!
+     * \brief Reserve space for members.
+     *
+     * \param n   Number of members.
+     */
+    void reserve(size_t n);
+
+    /*!
+     * \brief Remove all members and names.
+     */
+    void clear();
+
+    /*!
+     * \brief Add idle member.
+     *
+     * \param name        Name.
+     * \param sex         Sex.
+     * \param age         Age in birth moons [0, 255].
+     * \param birth_moon  Birth full moon.
+     * \param subject     Grammar subject phrase of the member's activities.
+     *                    If NoPhrase, activities start with a random subject.
+     *
+     * \return Returns the member identifier.
+     */
+    Id add(std::string_view name,
+           Troglodyte::Sex  sex,
+           int              age,
+           FullMoon         birth_moon,
+           PhraseId         subject = Grammar::NoPhrase);
+
+    /*!
+     * \brief Add idle member from troglodyte.
+     *
+     * \param trog      Troglodyte.
+     * \param subject   Grammar subject phrase of the member's activities.
+     *
+     * \return Returns the member identifier.
+     */
+    Id add(const Troglodyte &trog, PhraseId subject = Grammar::NoPhrase)
+    {
+      return add(trog.name(), trog.sex(), trog.age(), trog.birth_moon(),
+                 subject);
+    }
+
+    /*!
+     * \brief Number of members.
+     */
+    size_t size() const
+    {
+      return m_name.size();
+    }
+
+    /*!
+     * \brief Number of distinct names.
+     */
+    size_t num_names() const
+    {
+      return m_name_off.size() - 1;
+    }
+
+    /*!
+     * \brief Member's interned name identifier.
+     */
+    NameId name_id(Id i) const
+    {
+      return m_name[i];
+    }
+
+    /*!
+     * \brief Member's name.
+     */
+    std::string_view name(Id i) const
+    {
+      NameId n = m_name[i];
+
+      return std::string_view(m_pool.data() + m_name_off[n],
+                              m_name_off[n+1] - m_name_off[n]);
+    }
+
+    /*!
+     * \brief Member's sex.
+     */
+    Troglodyte::Sex sex(Id i) const
+    {
+      return (Troglodyte::Sex)m_sex[i];
+    }
+
+    /*!
+     * \brief Member's age.
+     */
+    int age(Id i) const
+    {
+      return m_age[i];
+    }
+
+    /*!
+     * \brief Member's birth moon.
+     */
+    FullMoon birth_moon(Id i) const
+    {
+      return (FullMoon)m_moon[i];
+    }
+
+    /*!
+     * \brief Member's grammar subject phrase.
+     */
+    PhraseId subject(Id i) const
+    {
+      return m_subject[i];
+    }
+
+    /*!
+     * \brief Set member's grammar subject phrase.
+     */
+    void subject(Id i, PhraseId subject)
+    {
+      m_subject[i] = subject;
+    }
+
+    /*!
+     * \brief Test if member is idle.
+     */
+    bool is_idle(Id i) const
+    {
+      return m_activity[0][i] == Grammar::NoPhrase;
+    }
+
+    /*!
+     * \brief Member's k'th activity phrase, NoPhrase past its end.
+     */
+    PhraseId activity(Id i, int k) const
+    {
+      return m_activity[k][i];
+    }
+
+    /*!
+     * \brief Set member's activity from a coded sentence about the member.
+     *
+     * \param i         Member identifier.
+     * \param sentence  Coded sentence. Its subject is not stored.
+     */
+    void activity(Id i, const Grammar::CodedSentence &sentence)
+    {
+      for(int k = 0; k < ActivityLen; ++k)
+      {
+        m_activity[k][i] = sentence.m_phrases[k+1];
+      }
+    }
+
+    /*!
+     * \brief Make member idle.
+     */
+    void idle(Id i)
+    {
+      for(int k = 0; k < ActivityLen; ++k)
+      {
+        m_activity[k][i] = Grammar::NoPhrase;
+      }
+    }
+
+    /*!
+     * \brief Column views for bulk processing.
+     * \{
+     */
+    const NameId *name_ids() const { return m_name.data(); }
+    const uint8_t *sexes() const { return m_sex.data(); }
+    const uint8_t *ages() const { return m_age.data(); }
+    const uint8_t *birth_moons() const { return m_moon.data(); }
+    const PhraseId *subjects() const { return m_subject.data(); }
+    const PhraseId *activities(int k) const { return m_activity[k].data(); }
+    /*! \} */
+
+    /*!
+     * \brief Call fn(i) for each member i in [first, last).
+     *
+     * \param first   First member.
+     * \param last    One past the last member.
+     * \param fn      Function.
+     */
+    template<typename Fn>
+    void for_each(Id first, Id last, Fn &&fn) const
+    {
+      for(Id i=first; i<last; ++i)
+      {
+        fn(i);
+      }
+    }
+
+    /*!
+     * \brief Call fn(i) for each member i.
+     *
+     * \param fn      Function.
+     */
+    template<typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      for_each(0, (Id)size(), fn);
+    }
+
+    /*!
+     * \brief Update the activity of every member in parallel.
+     *
+     * The activities are generated straight into the activity columns by
+     * GrammarView::generate_batch. Member i of step s draws from random number
+     * stream (seed, s * size() + i), so a run is reproducible for a seed
+     * regardless of the number of threads. A member whose sentence is just
+     * its subject becomes idle.
+     *
+     * \param grammar   The grammar.
+     * \param seed      Random number seed.
+     * \param threads   Number of threads. If 0, then one per hardware core.
+     * \param step      Simulation step.
+     */
+    void update(const GrammarView &grammar, uint64_t seed, unsigned threads,
+                uint64_t step);
+
+    /*!
+     * \brief Create activity description of member.
+     *
+     * \param i               Member identifier.
+     * \param grammar         The grammar of the activity phrases.
+     * \param [out] doin      Description buffer. Its capacity is reused.
+     */
+    void whatcha_doin(Id i, const GrammarView &grammar,
+                      std::string &doin) const;
+
+  protected:
+    PrefixTrie            m_names;      ///< name -> interned name identifier
+    std::string           m_pool;       ///< interned name characters
+    std::vector<uint32_t> m_name_off;   ///< name id -> offset into pool
+
+    std::vector<NameId>   m_name;       ///< member name identifiers
+    std::vector<uint8_t>  m_sex;        ///< member sexes
+    std::vector<uint8_t>  m_age;        ///< member ages
+    std::vector<uint8_t>  m_moon;       ///< member birth moons
+    std::vector<PhraseId> m_subject;    ///< member subject phrases
+    std::vector<PhraseId> m_activity[ActivityLen];  ///< activity phrases
+  };
+
+} // namespace clan
+
+#endif // _CLAN_POPULATION_H
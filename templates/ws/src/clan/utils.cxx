@@ -13,6 +13,7 @@
  */
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
 #include <iostream>
@@ -100,4 +101,78 @@ namespace clan
     return (unsigned)tse.count();
   }
 
+  PrefixTrie::PrefixTrie()
+  {
+    clear();
+  }
+
+  void PrefixTrie::clear()
+  {
+    m_nodes.assign(1, Node{0, 0, npos, 0});
+    m_size = 0;
+  }
+
+  bool PrefixTrie::insert(const std::string &key, size_t value)
+  {
+    uint32_t  node = 0;
+
+    if( key.empty() )
+    {
+      return false;
+    }
+
+    for(char c : key)
+    {
+      uint32_t  child = m_nodes[node].m_child;
+
+      while( child != 0 && m_nodes[child].m_c != c )
+      {
+        child = m_nodes[child].m_sibling;
+      }
+
+      if( child == 0 )
+      {
+        child = (uint32_t)m_nodes.size();
+        m_nodes.push_back(Node{0, m_nodes[node].m_child, npos, c});
+        m_nodes[node].m_child = child;
+      }
+
+      node = child;
+    }
+
+    if( m_nodes[node].m_value != npos )
+    {
+      return false;
+    }
+
+    m_nodes[node].m_value = value;
+    ++m_size;
+
+    return true;
+  }
+
+  size_t PrefixTrie::find(std::string_view key) const
+  {
+    uint32_t  node = 0;
+
+    for(char c : key)
+    {
+      uint32_t  child = m_nodes[node].m_child;
+
+      while( child != 0 && m_nodes[child].m_c != c )
+      {
+        child = m_nodes[child].m_sibling;
+      }
+
+      if( child == 0 )
+      {
+        return npos;
+      }
+
+      node = child;
+    }
+
+    return node != 0? m_nodes[node].m_value: npos;
+  }
+
 } // namespace clan
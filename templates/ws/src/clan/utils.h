@@ -15,8 +15,11 @@
 #define _CLAN_UTILS_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <stdint.h>
+
 namespace clan
 {
   /*!
@@ -24,6 +27,7 @@ namespace clan
    */
   typedef std::vector<std::string> StrVec;
   typedef std::vector<int> IntVec;
+  typedef std::vector<double> DblVec;
 
   /*!
    * \brief Trim leading left whitespace from string.
@@ -107,6 +111,72 @@ namespace clan
    */
   extern unsigned rng_seed();
 
+  /*!
+   * \brief Prefix trie of keys mapped to values.
+   *
+   * Finds a key in one pass over the key, independent of the number of
+   * keys. Nodes are stored in one vector as
+   * left-child, right-sibling links.
+   */
+  class PrefixTrie
+  {
+  public:
+    static const size_t npos = (size_t)-1;  ///< no value
+
+    /*!
+     * \brief Default constructor.
+     */
+    PrefixTrie();
+
+    /*!
+     * \brief Remove all keys.
+     */
+    void clear();
+
+    /*!
+     * \brief Insert key.
+     *
+     * \param key    Non-empty key.
+     * \param value  Value of key.
+     *
+     * \return Returns true on success, false if key is empty or already
+     * inserted.
+     */
+    bool insert(const std::string &key, size_t value);
+
+    /*!
+     * \brief Find key.
+     *
+     * \param key    Key.
+     *
+     * \return Returns the value of the key, npos if not found.
+     */
+    size_t find(std::string_view key) const;
+
+    /*!
+     * \brief Number of keys.
+     */
+    size_t size() const
+    {
+      return m_size;
+    }
+
+  protected:
+    /*!
+     * \brief Trie node.
+     */
+    struct Node
+    {
+      uint32_t  m_child;    ///< first child node, 0 if none
+      uint32_t  m_sibling;  ///< next sibling node, 0 if none
+      size_t    m_value;    ///< value of key ending here, npos if none
+      char      m_c;        ///< edge character into this node
+    };
+
+    std::vector<Node> m_nodes;  ///< nodes, root is node 0
+    size_t            m_size;   ///< number of keys
+  };
+
 } // namespace clan
 
 #endif // _CLAN_UTILS_H
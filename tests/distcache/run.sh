@@ -0,0 +1,73 @@
+#!/bin/sh
+# Package:  RN Makefile System Test
+# File:     run.sh
+# Desc:     Distribution cache build key tests.
+# Usage:    run.sh
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+testdir=$(realpath $(dirname $0))
+distcache=$(realpath ${testdir}/../../utils/distcache.sh)
+workdir=$(mktemp -d /tmp/rnmake-test-distcache.XXXXXX)
+pkg=${workdir}/pkg
+dep=${workdir}/dep/dist/dist.x86_64
+nfail=0
+
+trap "rm -rf ${workdir}" EXIT
+
+# package build key
+key()
+{
+  ${distcache} key --root=${pkg} --profile=test \
+    --dep-key=${dep}/cache.key 2>/dev/null
+}
+
+# check CASE COND...
+check()
+{
+  what="${1}"
+  shift
+  if test "${@}"
+  then
+    echo "  PASS: ${what}"
+  else
+    echo "  FAIL: ${what}"
+    nfail=$((nfail + 1))
+  fi
+}
+
+echo "Distribution cache build key"
+
+mkdir -p ${pkg}/src
+echo "int grunt;" > ${pkg}/src/grunt.c
+printf "**/obj\nsrc/grunt_gen.h\n" > ${pkg}/.gitignore
+
+k0=$(key)
+check "key is computed" -n "${k0}"
+
+# 'make deps' and 'make' add ignored generated headers and objects
+mkdir -p ${pkg}/src/obj
+echo "#define GRUNT 1" > ${pkg}/src/grunt_gen.h
+echo "object" > ${pkg}/src/obj/grunt.o
+check "generated files do not change the key" "$(key)" = "${k0}"
+
+echo "int roar;" >> ${pkg}/src/grunt.c
+k1=$(key)
+check "changed source changes the key" "${k1}" != "${k0}"
+
+# a dependency without a recorded key is keyed by its distribution content
+mkdir -p ${dep}/lib
+echo "v1" > ${dep}/lib/libdep.a
+k2=$(key)
+check "built dependency changes the key" "${k2}" != "${k1}"
+echo "v2" > ${dep}/lib/libdep.a
+check "rebuilt dependency changes the key" "$(key)" != "${k2}"
+echo "0123" > ${dep}/cache.key
+k3=$(key)
+echo "v3" > ${dep}/lib/libdep.a
+check "recorded dependency key is used" "$(key)" = "${k3}"
+
+exit ${nfail}
+
+#/*! \endcond RNMAKE_DOXY */
@@ -0,0 +1,102 @@
+#!/bin/sh
+# Package:  RN Makefile System Test
+# File:     run.sh
+# Desc:     NetMsgs rules tests with a stub generator.
+# Usage:    run.sh
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+testdir=$(realpath $(dirname $0))
+workdir=$(mktemp -d /tmp/rnmake-test-netmsgs.XXXXXX)
+nfail=0
+
+export NETMSGSGEN_LOG=${workdir}/netmsgsgen.log
+
+trap "rm -rf ${workdir}" EXIT
+
+# make NetMsgs sources of languages ${langs} in the work directory
+langs="c"
+netmsgs()
+{
+  ${MAKE:-make} -s -C ${workdir} -f ${testdir}/Makefile \
+    NETMSGS_LANGS="${langs}" netmsgs-all >/dev/null
+}
+
+# number of generator invocations [of language LANG]
+ngen()
+{
+  grep "^${1}" ${NETMSGSGEN_LOG} 2>/dev/null | wc -l
+}
+
+# check CASE COND...
+check()
+{
+  what="${1}"
+  shift
+  if test "${@}"
+  then
+    echo "  PASS: ${what}"
+  else
+    echo "  FAIL: ${what}"
+    nfail=$((nfail + 1))
+  fi
+}
+
+echo "NetMsgs rules"
+
+cat > ${workdir}/trog_msgs.xml <<EOX
+<netmsgs encoding="itv" endian="big">
+  <msgdef msgid="Grunt"><fielddef fname="loudness" ftype="u8"/></msgdef>
+</netmsgs>
+EOX
+
+netmsgs
+check "first run generates" $(ngen) -eq 1 -a -f ${workdir}/trog_msgs.h
+check "XML is shared in the work directory" \
+  -f ${workdir}/share/trog_msgs.xml -a ! -e ${testdir}/share
+
+# second run with identical XML, whether or not it is touched
+netmsgs
+check "second run does not generate" $(ngen) -eq 1
+sleep 1
+touch ${workdir}/trog_msgs.xml
+netmsgs
+check "touched identical XML does not generate" $(ngen) -eq 1
+
+# identical regenerated output keeps the header modification time
+mtime=$(stat -c %Y ${workdir}/trog_msgs.h)
+sleep 1
+rm -f ${workdir}/obj/netmsgs.cache
+touch ${workdir}/trog_msgs.xml
+netmsgs
+check "uncached XML regenerates" $(ngen) -eq 2
+check "identical output keeps header mtime" \
+  $(stat -c %Y ${workdir}/trog_msgs.h) -eq ${mtime}
+
+# a missing output forces regeneration
+rm -f ${workdir}/trog_msgs.h
+netmsgs
+check "missing output regenerates" $(ngen) -eq 3 -a -f ${workdir}/trog_msgs.h
+
+# an added language generates just that language
+langs="c python"
+netmsgs
+check "added python generates python only" \
+  $(ngen python) -eq 1 -a $(ngen c) -eq 3 -a -f ${workdir}/trog_msgs.py
+netmsgs
+check "second python run does not generate" $(ngen) -eq 4
+
+# changed XML content regenerates every language
+sleep 1
+sed -i -e 's/Grunt/Roar/' ${workdir}/trog_msgs.xml
+netmsgs
+check "changed XML regenerates all languages" \
+  $(ngen python) -eq 2 -a $(ngen c) -eq 4
+check "changed XML is in the outputs" \
+  $(grep -c Roar ${workdir}/trog_msgs.h ${workdir}/trog_msgs.c \
+                 ${workdir}/trog_msgs.py | grep -c ':1$') -eq 3
+
+exit ${nfail}
+
+#/*! \endcond RNMAKE_DOXY */
@@ -0,0 +1,342 @@
+#!/bin/sh
+# Package:  RN Makefile System Utility
+# File:     distcache.sh
+# Desc:     Prebuilt package distribution tree cache.
+# Usage:    distcache.sh key [OPTIONS] [FILE...]
+#           distcache.sh lookup|store|restore [OPTIONS]
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+argv0=$(basename $0)
+
+print_help()
+{
+  cat <<EOH
+Usage: ${argv0} key [OPTIONS] [FILE...]
+       ${argv0} lookup [OPTIONS]
+       ${argv0} store [OPTIONS]
+       ${argv0} restore [OPTIONS]
+       ${argv0} --help
+
+Maintain a cache of built package distribution trees.
+
+Commands:
+  key       Print the package build key. The key is a hash of the content of
+            all package source files (see src-filter.sh), any additional FILEs,
+            the build profile, and the keys of dependency packages. Files the
+            package root .gitignore lists, such as generated headers, are
+            build outputs and are not keyed.
+  lookup    Print the cached archive path if KEY is cached, else nothing.
+  store     Archive distribution directory DIST into the cache under KEY.
+  restore   Extract the cached archive for KEY into distribution directory
+            DIST. Exits with status 1 if KEY is not cached.
+
+Options:
+  -c, --cache-dir=DIR   Cache directory. A DIR of the form [user@]host:path
+                        is accessed with rsync. Required for all but key.
+  -d, --dist=DIST       Package distribution directory (e.g.
+                        dist/dist.x86_64).
+  -k, --key=KEY         Package build key.
+  -n, --name=NAME       Cache entry name (e.g. pkg/x86_64).
+  -r, --root=ROOT       Package root directory. Default: .
+  -p, --profile=STR     Build profile string included in the key (e.g. arch
+                        and compiler flags).
+  -x, --exclude=FILE    Exclude generated source FILE from the key. May be
+                        iterated.
+  -D, --dep-key=FILE    Include the key recorded in dependency package FILE.
+                        If FILE is missing, the content of its distribution
+                        directory is keyed instead, or 'none' if that is
+                        missing, too. May be iterated.
+
+      --help            Print this help and exit.
+EOH
+}
+
+# long and short options
+longopts="cache-dir:,dist:,key:,name:,root:,profile:,exclude:,dep-key:,help"
+shortopts="c:d:k:n:r:p:x:D:h"
+
+cmd="${1}"
+case "${cmd}" in
+  key|lookup|store|restore) shift;;
+  -h|--help) print_help; exit 0;;
+  *)
+    echo "rnmake: ${argv0}: error: unknown command '${cmd}'" >&2
+    exit 2;;
+esac
+
+# Option defaults
+cachedir=
+distdir=
+key=
+name=
+root=.
+profile=
+excludes=
+depkeys=
+
+# get the command-line options
+#   order returned: OPTIONS -- ARGS OTHER_OPTIONS
+OPTS=$(getopt --name ${argv0} -o "${shortopts}" --long "${longopts}" -- "${@}")
+
+if [ $? != 0 ]
+then
+  echo "rnmake: ${argv0}: error: bad option(s), try '${argv0} --help'" >&2
+  exit 2
+fi
+
+eval set -- "${OPTS}"
+
+# process command-line options
+while true
+do
+  case "$1" in
+    -h|--help) print_help; exit 0;;
+    -c|--cache-dir) cachedir="${2}"; shift 2;;
+    -d|--dist) distdir="${2}"; shift 2;;
+    -k|--key) key="${2}"; shift 2;;
+    -n|--name) name="${2}"; shift 2;;
+    -r|--root) root="${2}"; shift 2;;
+    -p|--profile) profile="${2}"; shift 2;;
+    -x|--exclude) excludes="${excludes} ${2}"; shift 2;;
+    -D|--dep-key) depkeys="${depkeys} ${2}"; shift 2;;
+    --) shift; break;;
+    *) break;
+  esac
+done
+
+#
+# Print shell glob patterns of the paths, relative to the package root, that
+# the gitignore(5) patterns on stdin list. Negated patterns are not supported.
+#
+ignore_globs()
+{
+  while read -r p
+  do
+    case "${p}" in
+      ''|'#'*|'!'*) continue;;
+    esac
+    p="${p%/}"
+    case "${p}" in
+      '**/'*) p="${p#'**/'}"; echo "*/${p}"; echo "*/${p}/*";;
+      */*)    p="${p#/}"; echo "./${p}"; echo "./${p}/*";;
+      *)      echo "*/${p}"; echo "*/${p}/*";;
+    esac
+  done
+}
+
+#
+# Print key of distribution directory content.
+#
+dist_tree_key()
+{
+  ( cd "${1}" && find . -type f ! -name cache.key | \
+    LC_ALL=C sort | xargs -r -d '\n' sha1sum ) | sha1sum | cut -d' ' -f1
+}
+
+#
+# Print build key.
+#
+do_key()
+{
+  utils=$(realpath $(dirname $0))
+
+  # no pathname expansion of the glob patterns
+  set -f
+
+  # ignored files are build outputs (e.g. generated headers)
+  ignores=
+  if [ -f "${root}/.gitignore" ]
+  then
+    ignores=$(ignore_globs < "${root}/.gitignore")
+  fi
+
+  # excluded files relative to package root
+  relexcludes=
+  for x in ${excludes}
+  do
+    relexcludes="${relexcludes} ./$(realpath -m --relative-to=${root} ${x})"
+  done
+
+  # source files (a failed filter must not yield a key without sources)
+  srcs=$(mktemp /tmp/rnmake-distcache.XXXXXX)
+  if ! ( cd ${root} && ${utils}/src-filter.sh . ) > ${srcs}
+  then
+    rm -f ${srcs}
+    echo "rnmake: ${argv0}: error: key: cannot list source files of ${root}" >&2
+    return 8
+  fi
+
+  {
+    # source content
+    while read f
+    do
+      if [ -f "${root}/${f}" ]
+      then
+        for x in ${relexcludes}
+        do
+          if [ "${f}" = "${x}" ]
+          then
+            continue 2
+          fi
+        done
+        for g in ${ignores}
+        do
+          case "${f}" in
+            ${g}) continue 2;;
+          esac
+        done
+        echo "${f}"
+      fi
+    done < ${srcs} | \
+    LC_ALL=C sort | \
+    ( cd ${root} && xargs -r -d '\n' sha1sum )
+
+    # additional build files (package.mk, Arch.*.mk, etc)
+    for f in "${@}"
+    do
+      if [ -f "${f}" ]
+      then
+        echo "$(sha1sum < ${f}) $(basename ${f})"
+      fi
+    done
+
+    # build profile
+    echo "profile: ${profile}"
+
+    # dependency package keys (an uncached dependency is keyed by the
+    # content of its distribution, so rebuilding it changes this key)
+    for f in ${depkeys}
+    do
+      if [ -f "${f}" ]
+      then
+        echo "dep: $(cat ${f})"
+      elif [ -d "$(dirname ${f})" ]
+      then
+        echo "dep: tree $(dist_tree_key $(dirname ${f}))"
+      else
+        echo "dep: none"
+      fi
+    done
+  } | sha1sum | cut -d' ' -f1
+
+  rm -f ${srcs}
+}
+
+#
+# Check required options.
+#
+require()
+{
+  for opt in "${@}"
+  do
+    eval v=\$${opt}
+    if [ -z "${v}" ]
+    then
+      echo "rnmake: ${argv0}: error: ${cmd}: no ${opt} specified" >&2
+      exit 2
+    fi
+  done
+}
+
+# is cache directory a remote rsync path?
+is_remote()
+{
+  case "${cachedir}" in
+    *:*) return 0;;
+    *) return 1;;
+  esac
+}
+
+#
+# Print cached archive path if cached.
+#
+do_lookup()
+{
+  require cachedir name key
+  archive=${cachedir}/${name}/${key}.tar.gz
+  if is_remote
+  then
+    if rsync --list-only "${archive}" >/dev/null 2>&1
+    then
+      echo "${archive}"
+    fi
+  elif [ -f "${archive}" ]
+  then
+    echo "${archive}"
+  fi
+}
+
+#
+# Store distribution tree in cache. The archive is written to a temporary file
+# and renamed so concurrent readers never see a partial archive.
+#
+do_store()
+{
+  require cachedir name key distdir
+  if [ ! -d "${distdir}" ]
+  then
+    echo "rnmake: ${argv0}: error: ${distdir}: no distribution directory" >&2
+    exit 4
+  fi
+  tmp=$(mktemp /tmp/rnmake-distcache.XXXXXX)
+  tar --create --gzip --exclude=./tmp --file ${tmp} -C ${distdir} .
+  if is_remote
+  then
+    host=${cachedir%%:*}
+    dir=${cachedir#*:}/${name}
+    ssh ${host} "mkdir -p -m 775 ${dir}" && \
+    rsync -q ${tmp} ${host}:${dir}/${key}.tar.gz
+  else
+    dir=${cachedir}/${name}
+    test -d ${dir} || mkdir -p -m 775 ${dir}
+    cp ${tmp} ${dir}/.${key}.$$ && mv -f ${dir}/.${key}.$$ ${dir}/${key}.tar.gz
+  fi
+  rc=$?
+  rm -f ${tmp}
+  if [ ${rc} -eq 0 ]
+  then
+    echo "  stored ${name} ${key}"
+  fi
+  return ${rc}
+}
+
+#
+# Restore distribution tree from cache.
+#
+do_restore()
+{
+  require cachedir name key distdir
+  archive=$(do_lookup)
+  if [ -z "${archive}" ]
+  then
+    return 1
+  fi
+  test -d ${distdir} || mkdir -p -m 775 ${distdir}
+  if is_remote
+  then
+    tmp=$(mktemp /tmp/rnmake-distcache.XXXXXX)
+    rsync -q "${archive}" ${tmp} && \
+    tar --extract --gzip --file ${tmp} -C ${distdir}
+    rc=$?
+    rm -f ${tmp}
+  else
+    tar --extract --gzip --file ${archive} -C ${distdir}
+    rc=$?
+  fi
+  if [ ${rc} -eq 0 ]
+  then
+    echo "  restored ${name} ${key}"
+  fi
+  return ${rc}
+}
+
+case "${cmd}" in
+  key)      do_key "${@}"; exit $?;;
+  lookup)   do_lookup;;
+  store)    do_store;;
+  restore)  do_restore;;
+esac
+
+#/*! \endcond RNMAKE_DOXY */
@@ -18,6 +18,10 @@ Usage: ${argv0} [OPTIONS] SRCDIR DSTDIR
 Install files for source directory to destination directory.
 
 Options:
+  -c, --changed-only    Only install files whose content differs from the
+                        installed file. Unchanged installed files keep their
+                        modification times. With stripping, installed files
+                        are compared to stripped copies of the source files.
   -o, --strip-opt=OPT   Strip program option. May be iterated.
   -p, --strip-pgm=PGM   Strip program.
       --verbose         Print verbose install progress.
@@ -27,11 +31,12 @@ EOH
 }
 
 # long and short options
-longopts="strip-pgm:,strip-opt:,verbose,help"
-shortopts="p:o:h"
+longopts="changed-only,strip-pgm:,strip-opt:,verbose,help"
+shortopts="cp:o:h"
 
 # Option defaults
 verbose=
+changed_only=
 strip_pgm=
 strip_opts=
 
@@ -57,6 +62,7 @@ do
   case "$1" in
     -h|--help) print_help; exit 0;;
     --verbose) verbose=1 shift;;
+    -c|--changed-only) changed_only=1; shift;;
     -p|--strip-pgm) strip_pgm="${2}"; shift 2;;
     -o|--strip-opt) strip_opts="${strip_opts} ${2}"; shift 2;;
     --) shift; break;;
@@ -87,13 +93,37 @@ then
   exit 4
 fi
 
+#
+# Test if the installed file is current with the source file. With stripping,
+# the installed file is compared to a stripped copy of the source file.
+#
+current()
+{
+  if [ -z "${strip_pgm}" ]
+  then
+    cmp -s ${1} ${2}
+    return $?
+  fi
+  tmp=$(mktemp) || return 1
+  cp ${1} ${tmp}
+  ${strip_pgm} ${strip_opts} ${tmp} >/dev/null 2>/dev/null
+  cmp -s ${tmp} ${2}
+  rc=$?
+  rm -f ${tmp}
+  return ${rc}
+}
+
 #
 # Install files
 #
 find . -type f -o -type l | \
 grep -v \.svn | \
+{
+nchanged=0
+ntotal=0
 while read srcpath
 do
+  ntotal=$((ntotal + 1))
   # strip leading './'
 	src="${srcpath##./}"
   # destination [sub]directory name
@@ -105,9 +135,17 @@ do
   fi
   # destination file name
 	dst="${dstdir}/${src}"
-  if [ "${verbose}" ]
-  then 
-	  echo "  ${dst}"
+  # installed symlink is current
+  if [ "${changed_only}" -a -h ${srcpath} -a -h ${dst} ] && \
+     [ "$(readlink ${srcpath})" = "$(readlink ${dst})" ]
+  then
+    continue
+  fi
+  # content of installed regular file is current
+  if [ "${changed_only}" -a ! -h ${srcpath} -a -f ${dst} ] && \
+     current ${srcpath} ${dst}
+  then
+    continue
   fi
   # 'install' symlink file
   if [ -h ${srcpath} ]
@@ -115,16 +153,26 @@ do
     lnk=$(readlink ${srcpath})
     cd ${dname} >/dev/null
     fname=$(basename ${srcpath})
-    if [ ! -f ${fname} ]
+    if [ -h ${fname} -o -e ${fname} ]
     then
-      ln -s ${lnk} ${fname}
+      cd - >/dev/null
+      continue
     fi
+    ln -s ${lnk} ${fname}
     cd - >/dev/null
+    if [ "${verbose}" ]
+    then 
+      echo "  ${dst}"
+    fi
   # install regular file with given permissions
   else
+    if [ "${verbose}" ]
+    then 
+      echo "  ${dst}"
+    fi
     mode=$(stat -c '%a' ${srcpath})
     install -p -m ${mode} ${srcpath} ${dst}
-    if [ -n ${strip_pgm} ]
+    if [ -n "${strip_pgm}" ]
     then
       ${strip_pgm} ${strip_opts} ${dst} >/dev/null 2>/dev/null
       if [ "${verbose}" -a ${?} = 0 ]
@@ -133,6 +181,12 @@ do
       fi
     fi
   fi
+  nchanged=$((nchanged + 1))
 done
+if [ "${changed_only}" ]
+then
+  echo "  ${nchanged} of ${ntotal} files changed"
+fi
+}
 
 #/*! \endcond RNMAKE_DOXY */
@@ -2,13 +2,15 @@
 # Package:  RN Makefile System Utility
 # File:     dpkg-helper.sh
 # Desc:     Build debian package
-# Usage:    dpkg-helper <dev|src|doc> 
+# Usage:    dpkg-helper -a ARCH -c CONFDIR -d DISTDIR -t TMPDIR -n NAME
+#                       -p PREFIX -v VERSION -y PKGTYPE
+#                       [-Z COMPRESS] [-z LEVEL] [-j THREADS] [-s EPOCH]
 #
 # /*! \file */
 # /*! \cond RNMAKE_DOXY*/
 
 
-optstr="a:c:d:n:p:t:v:y:"
+optstr="a:c:d:j:n:p:s:t:v:y:z:Z:"
 
 dist_dir=
 deb_arch=
@@ -18,6 +20,10 @@ deb_prefix=
 deb_tmpdir=
 deb_version=
 pkg_type=
+deb_compress=xz
+deb_level=
+deb_threads=1
+deb_epoch=
 
 while getopts :${optstr} opt
 do
@@ -28,9 +34,13 @@ do
 
     d) dist_dir=${OPTARG} ;;
 
+    j) deb_threads=${OPTARG} ;;
+
     n) deb_name=${OPTARG} ;;
 
     p) deb_prefix=${OPTARG} ;;
+
+    s) deb_epoch=${OPTARG} ;;
       
     t) deb_tmpdir=${OPTARG} ;;
 
@@ -38,6 +48,10 @@ do
 
     y) pkg_type=${OPTARG} ;;
 
+    z) deb_level=${OPTARG} ;;
+
+    Z) deb_compress=${OPTARG} ;;
+
     *) echo "rnmake: $0: error: Unknown opt: $opt"; exit 2;;
   esac
 done
@@ -58,25 +72,22 @@ esac
 
 # working temp dir
 deb_tmpdir=${deb_tmpdir}-${deb_arch}
+deb_file=${deb_name}-${deb_arch}.deb
 
 echo "Found debian package configuration directory"
 echo "  ${deb_confdir}" 
 echo "Package parameters:"
-echo "  package        = ${deb_name}.deb"
+echo "  package        = ${deb_file}"
 echo "  architecture   = ${deb_arch}"
 echo "  version        = ${deb_version}"
 echo "  install prefix = ${deb_prefix}"
+echo "  compression    = ${deb_compress}"
 
-if [ ! -e $deb_tmpdir ]
-then
-  mkdir -p $deb_tmpdir/DEBIAN
-  mkdir -p $deb_tmpdir/$deb_prefix
-fi
-
-if [ ! -e $repo_dir ]
-then
-  mkdir -p $repo_dir
-fi
+# start from a clean staging tree (stale files must not be packaged)
+rm -rf $deb_tmpdir
+mkdir -p $deb_tmpdir/DEBIAN
+mkdir -p $deb_tmpdir/$deb_prefix
+mkdir -p $repo_dir
 
 cp -r $deb_confdir/* ${deb_tmpdir}/DEBIAN/.
 
@@ -87,33 +98,94 @@ sed_prefix="s%@PREFIX@%${deb_prefix}%"
 
 for f in control prerm postinst
 do
-  sed -e $sed_version -e $sed_arch -e $sed_prefix \
-    --in-place $deb_tmpdir/DEBIAN/$f
+  if [ -f $deb_tmpdir/DEBIAN/$f ]
+  then
+    sed -e $sed_version -e $sed_arch -e $sed_prefix \
+      --in-place $deb_tmpdir/DEBIAN/$f
+  fi
 done
 
-# copying files from dist
+#
+# stage src dst
+#
+# Stage distribution directory by hardlinks, falling back to copies if the
+# staging directory is on another file system.
+#
+stage()
+{
+  if [ -e "$1" ]
+  then
+    cp -al "$1" "$2" 2>/dev/null || cp -a "$1" "$2"
+  fi
+}
+
+# staging files from dist
 case $pkg_type in
   pkgtype-dev) echo "Creating debian development package."; \
-               cp -r ${dist_dir}/bin ${deb_tmpdir}/${deb_prefix}/.;
-               cp -r ${dist_dir}/lib ${deb_tmpdir}/${deb_prefix}/.;
-               cp -r ${dist_dir}/include ${deb_tmpdir}/${deb_prefix}/.;
-               cp -r ${dist_dir}/share ${deb_tmpdir}/${deb_prefix}/.;
-               cp -r ${dist_dir}/etc ${deb_tmpdir}/.;;
+               stage ${dist_dir}/bin ${deb_tmpdir}/${deb_prefix}/.;
+               stage ${dist_dir}/lib ${deb_tmpdir}/${deb_prefix}/.;
+               stage ${dist_dir}/include ${deb_tmpdir}/${deb_prefix}/.;
+               stage ${dist_dir}/share ${deb_tmpdir}/${deb_prefix}/.;
+               stage ${dist_dir}/etc ${deb_tmpdir}/.;;
   
   pkgtype-src) echo "Creating debian source package."; \
-               cp -r ${dist_dir}/src ${deb_tmpdir}/${deb_prefix}/.;;
+               stage ${dist_dir}/src ${deb_tmpdir}/${deb_prefix}/.;;
 
   pkgtype-doc) echo "Creating debian document package."; \
-               cp -r ${dist_dir}/doc ${deb_tmpdir}/${deb_prefix}/.;;
+               stage ${dist_dir}/doc ${deb_tmpdir}/${deb_prefix}/.;;
 
   *)           echo "rnmake does not support the requested debian package type";
-               echo "   * " $deb_type
+               echo "   * " $pkg_type;
+               exit 2;;
 esac
 
-fakeroot -- dpkg-deb --build $deb_tmpdir 1>/dev/null
-mv $dist_dir/tmp/deb/$deb_name-$deb_arch.deb $repo_dir/.
+# compressor options (fall back to xz if dpkg-deb does not know zstd)
+deb_opts="-Z${deb_compress}"
+if [ -n "${deb_level}" ]
+then
+  deb_opts="${deb_opts} -z${deb_level}"
+fi
+
+deb_help=$(dpkg-deb --help 2>/dev/null)
+
+case $deb_help in
+  *threads-max*) deb_opts="${deb_opts} --threads-max=${deb_threads}";;
+esac
+
+# root:root ownership without fakeroot, if supported
+case $deb_help in
+  *root-owner-group*) deb_cmd="dpkg-deb --root-owner-group";;
+  *)                  deb_cmd="fakeroot -- dpkg-deb";;
+esac
+
+# reproducible packages: file timestamps are clamped to the source date epoch
+if [ -n "${deb_epoch}" ]
+then
+  SOURCE_DATE_EPOCH=${deb_epoch}
+  export SOURCE_DATE_EPOCH
+fi
+
+# build to a temporary name, then replace the package atomically
+deb_out=${repo_dir}/.${deb_file}.$$
+
+if ! $deb_cmd $deb_opts --build $deb_tmpdir $deb_out 1>/dev/null 2>&1
+then
+  if [ "${deb_compress}" = "zstd" ]
+  then
+    echo "  zstd compression not supported by dpkg-deb, using xz"
+    deb_opts=$(echo "${deb_opts}" | sed -e 's/-Zzstd/-Zxz/')
+  fi
+  if ! $deb_cmd $deb_opts --build $deb_tmpdir $deb_out 1>/dev/null
+  then
+    rm -f $deb_out
+    echo "rnmake: $0: error: ${deb_file}: dpkg-deb failed" 1>&2
+    exit 8
+  fi
+fi
+
+mv -f $deb_out $repo_dir/$deb_file
 
-echo "  $repo_dir/$deb_name-$deb_arch.deb"
+echo "  $repo_dir/$deb_file"
 echo "Done."
 
 #/*! \endcond RNMAKE_DOXY */
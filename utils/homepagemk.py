@@ -18,6 +18,8 @@ import os
 import time
 import shutil
 import re
+import json
+import hashlib
 import getopt
 
 from pprint import pprint
@@ -201,7 +203,48 @@ class HomeMaker:
     else:
       print("<p>no documentation</p>", file=fp)
 
+  def inputs_hash(self):
+    """
+    Hash of the home page inputs: the template, the variables, and which of
+    the release files and documentation indices exist (the page links to them,
+    it does not include their content).
+    """
+    h = hashlib.sha256()
+    try:
+      with open(self.paths['template'], 'rb') as fp:
+        h.update(fp.read())
+    except OSError:
+      pass
+    html_vars = {k: v for k, v in self.html_vars.items() if isinstance(v, str)}
+    h.update(json.dumps({'paths': self.paths, 'vars': html_vars},
+                        sort_keys=True).encode('utf-8'))
+    return h.hexdigest()
+
+  def is_up_to_date(self, digest):
+    """ Test if home page was made from the same inputs. """
+    if not self.kwargs['cache'] or not os.path.isfile(self.paths['index_html']):
+      return False
+    try:
+      with open(self.kwargs['cache']) as fp:
+        return fp.read().strip() == digest
+    except OSError:
+      return False
+
+  def write_cache(self, digest):
+    """ Write home page inputs hash. """
+    if not self.kwargs['cache']:
+      return
+    d = os.path.dirname(self.kwargs['cache'])
+    if d and not os.path.isdir(d):
+      os.makedirs(d)
+    with open(self.kwargs['cache'], 'w') as fp:
+      print(digest, file=fp)
+
   def make_html_index(self):
+    digest = self.inputs_hash()
+    if self.is_up_to_date(digest):
+      self.verbose(f"{self.paths['index_html']} is up to date")
+      return
     self.verbose(f"Making {self.paths['index_html']}")
     if not self.paths['template']:
       self.out.iowarning("No template file - skipping",
@@ -211,6 +254,7 @@ class HomeMaker:
     postfile = self.atat.replace_in_file(self.paths['template'], False)
     self.verbose("Moving to index.html")
     shutil.move(postfile, self.paths['index_html'])
+    self.write_cache(digest)
     self.verbose('')
 
   def show(self):
@@ -292,6 +336,10 @@ Generate top-level home index.html page for documetation distribution.
 The index.html page will be created under the DOC_ROOT path directory.
 
 Options:
+      --cache=FILE          Inputs hash file. The index.html page is made only
+                            if its inputs changed since the last run.
+                            Default: no cache (always made)
+
       --debug               Enable debugging.
 
       --doxy-index=INDEX    Doxygen generated index.html page.
@@ -358,9 +406,10 @@ See '{self.argv0} --show ref' for referenced variables in template.
     kwargs['rel_files']   = []
     kwargs['show']        = []
     kwargs['atat']        = {}
+    kwargs['cache']       = None
 
     shortopts = "?h"
-    longopts  = ['help', 'debug', 'doxy-index=', 'images-path=', 'no-color',
+    longopts  = ['help', 'cache=', 'debug', 'doxy-index=', 'images-path=', 'no-color',
                  'pub-dir=', 'pydoc-index=', 'rel-files=', 'show=', 'verbose']
     show_args = ['def', 'ref', 'pre', 'post']
 
@@ -377,6 +426,8 @@ See '{self.argv0} --show ref' for referenced variables in template.
         elif opt in ('--no-color',):
           kwargs['color'] = False
           self.turn_off_color()
+        elif opt in ('--cache',):
+          kwargs['cache'] = optarg
         elif opt in ('--doxy-index'):
           kwargs['doxy_index'] = optarg
         elif opt in ('--images-path'):
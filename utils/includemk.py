@@ -0,0 +1,396 @@
+#!/usr/bin/env python3
+#
+# File:
+#   includemk.py
+#
+# Usage:
+#   includemk.py [OPTIONS] DEPFILES_FILE
+#   includemk.py --help
+#
+# Description:
+#   Report package headers ranked by the recompilation their edits trigger, and
+#   heavy or redundant system includes pulled into package headers, from the
+#   rnmake header dependency files.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+import sys
+import os
+import re
+import json
+import subprocess
+import getopt
+
+# fix up python path
+sys.path.insert(0, os.path.realpath(os.path.dirname(__file__)))
+
+try:
+  from rnmake.color import ColorfulOutput
+except ImportError as e:
+  print(f"{e}: Expeceted to be found in 'PREFIX/rnmake/utils/rnmake'")
+  sys.exit(8)
+
+# #include directive
+ReInclude = re.compile(r'^\s*#\s*include\s*([<"])([^>"]+)[>"]')
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+def read_depfile(path):
+  """
+  Read make dependency file of 'obj: source header...' rules.
+
+  Paths are relative to the directory owning the .deps directory.
+
+  Return:
+    List of (source, [headers]) tuples of absolute paths.
+  """
+  base = os.path.dirname(os.path.dirname(os.path.abspath(path)))
+  tus = []
+  try:
+    with open(path) as fp:
+      text = fp.read().replace('\\\n', ' ')
+  except OSError:
+    return tus
+  for line in text.splitlines():
+    if line.startswith('#') or ':' not in line:
+      continue
+    prereqs = line.split(':', 1)[1].split()
+    if not prereqs:
+      continue
+    prereqs = [os.path.normpath(os.path.join(base, p)) for p in prereqs]
+    tus.append((prereqs[0], prereqs[1:]))
+  return tus
+
+# -----------------------------------------------------------------------------
+class IncludeMaker:
+  """ Include graph reporter class. """
+
+  def __init__(self):
+    self.out    = ColorfulOutput()
+    self.sizes  = {}    # file -> size in bytes
+    self.weights = {}   # system include name -> closure size in bytes
+
+  def file_size(self, path):
+    """ Size of file in bytes (memoized). """
+    if path not in self.sizes:
+      try:
+        self.sizes[path] = os.path.getsize(path)
+      except OSError:
+        self.sizes[path] = 0
+    return self.sizes[path]
+
+  def is_pkg_file(self, path):
+    """ Test if file is in the package. """
+    return path.startswith(self.kwargs['root'] + os.sep)
+
+  def direct_includes(self, path):
+    """ Names and delimiters of the #include directives of a file. """
+    incs = []
+    try:
+      with open(path, errors='replace') as fp:
+        for line in fp:
+          m = ReInclude.match(line)
+          if m:
+            incs.append((m.group(2), m.group(1)))
+    except OSError:
+      pass
+    return incs
+
+  def system_weight(self, name):
+    """
+    Preprocessor input size of a system include, from its dependency closure.
+
+    Return:
+      Size in bytes or None if unknown.
+    """
+    if name in self.weights:
+      return self.weights[name]
+    weight = None
+    cmd = self.kwargs['cxx'].split() + ['-x', 'c++', '-M', '-']
+    try:
+      completed = subprocess.run(cmd, input=f"#include <{name}>\n",
+                                 stdout=subprocess.PIPE,
+                                 stderr=subprocess.DEVNULL, encoding='utf-8',
+                                 errors='replace')
+      if completed.returncode == 0:
+        text = completed.stdout.replace('\\\n', ' ')
+        deps = text.split(':', 1)[1].split() if ':' in text else []
+        weight = sum(self.file_size(os.path.normpath(d)) for d in deps
+                     if d != '-')
+    except OSError:
+      pass
+    self.weights[name] = weight
+    return weight
+
+  def analyze(self, tus):
+    """
+    Analyze translation units.
+
+    Return:
+      Report dictionary.
+    """
+    # compile cost of a translation unit is its total preprocessor input size
+    total_cost = 0
+    headers = {}    # header -> {'tus': n, 'cost': bytes}
+    for src, hdrs in tus:
+      cost = self.file_size(src) + sum(map(self.file_size, set(hdrs)))
+      total_cost += cost
+      for hdr in set(hdrs):
+        h = headers.setdefault(hdr, {'tus': 0, 'cost': 0})
+        h['tus']  += 1
+        h['cost'] += cost
+
+    pkg_hdrs = sorted(h for h in headers if self.is_pkg_file(h))
+
+    # direct include graph of package headers
+    graph = {}    # header -> (package headers, system include names)
+    for hdr in pkg_hdrs:
+      pkgs, syss = [], []
+      for name, delim in self.direct_includes(hdr):
+        match = [h for h in pkg_hdrs if h.endswith(os.sep + name)]
+        if match:
+          pkgs.append(match[0])
+        elif delim == '<':
+          syss.append(name)
+      graph[hdr] = (pkgs, syss)
+
+    closure = {}    # header -> system include names reachable from header
+
+    def reach(hdr, visiting):
+      if hdr in closure:
+        return closure[hdr]
+      if hdr in visiting:
+        return set()
+      visiting.add(hdr)
+      names = set(graph[hdr][1])
+      for dep in graph[hdr][0]:
+        names |= reach(dep, visiting)
+      closure[hdr] = names
+      return names
+
+    heavy = []
+    for hdr in pkg_hdrs:
+      pkgs, syss = graph[hdr]
+      via = set()
+      for dep in pkgs:
+        via |= reach(dep, set())
+      for name in syss:
+        weight = self.system_weight(name)
+        redundant = name in via
+        if not redundant and \
+            (weight is None or weight < self.kwargs['heavy'] * 1024):
+          continue
+        heavy.append({'header':     self.relpath(hdr),
+                      'include':    name,
+                      'tus':        headers[hdr]['tus'],
+                      'weight':     weight,
+                      'amplified':  (weight or 0) * headers[hdr]['tus'],
+                      'redundant':  redundant})
+    heavy.sort(key=lambda h: (-h['amplified'], h['header'], h['include']))
+
+    ranked = [{'header':  self.relpath(hdr),
+               'tus':     headers[hdr]['tus'],
+               'cost':    headers[hdr]['cost'],
+               'share':   round(100.0 * headers[hdr]['cost'] / total_cost, 1)
+                            if total_cost > 0 else 0.0}
+              for hdr in pkg_hdrs]
+    ranked.sort(key=lambda h: (-h['cost'], h['header']))
+
+    return {'tus':      len(tus),
+            'cost':     total_cost,
+            'headers':  ranked,
+            'heavy':    heavy}
+
+  def relpath(self, path):
+    """ Path relative to package root. """
+    return os.path.relpath(path, self.kwargs['root'])
+
+  def print_report(self, rpt):
+    """ Print include report. """
+    top = self.kwargs['top']
+    print(f"{rpt['tus']} translation units, "
+          f"{rpt['cost'] // 1024} KB total preprocessor input")
+    print('')
+    self.out.cprint('yellow', 'Package headers by rebuild cost:')
+    print(f"  {'TUs':>5} {'cost KB':>10} {'share':>6}  header")
+    for h in rpt['headers'][:top]:
+      print(f"  {h['tus']:>5} {h['cost'] // 1024:>10} {h['share']:>5}%  "
+            f"{h['header']}")
+    print('')
+    self.out.cprint('yellow', 'Heavy or redundant system includes in package '
+                              'headers:')
+    if not rpt['heavy']:
+      print('  (none)')
+    else:
+      print(f"  {'TUs':>5} {'size KB':>10}  header: include")
+    for h in rpt['heavy'][:top]:
+      weight = '-' if h['weight'] is None else h['weight'] // 1024
+      line = f"  {h['tus']:>5} {weight:>10}  {h['header']}: <{h['include']}>"
+      if h['redundant']:
+        line += ' (redundant)'
+      print(line)
+
+  def fatal(self, ec, *emsgs):
+    """ Show fatal message and exit. """
+    self.out.fatal(*emsgs)
+    sys.exit(ec)
+
+  def turn_off_color(self):
+    """ Disable color output. """
+    self.out.disable_color()
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}")
+    else:
+      print(f"{self.argv0}: error")
+    print(f"Try '{self.argv0} --help' for more information.")
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] DEPFILES_FILE
+       {self.argv0} --help
+
+Report package headers ranked by rebuild cost and heavy or redundant system
+includes of package headers.
+
+Options:
+      --cxx=CMD         C++ compiler command used to size system includes.
+                        Default: c++
+
+      --heavy=KB        System includes with at least KB kilobytes of
+                        preprocessor input are heavy. Default: 256
+
+      --no-color        Disable color output.
+
+      --output=FILE     Write JSON report to FILE.
+
+      --root=DIR        Package root directory. Headers under DIR are package
+                        headers. Default: .
+
+      --top=N           Number of entries reported per section. Default: 20
+
+  -h, --help            Display this help and exit.
+
+Description:
+DEPFILES_FILE
+List of rnmake dependency files (.deps/deps.ARCH), one per line.
+
+The compile cost of a translation unit is the total size of its source and all
+headers it includes. The rebuild cost of a header is the sum of the compile
+costs of the translation units that include it, directly or transitively.
+
+A system include of a package header is redundant if the header also reaches it
+through another included package header.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    self.out.set_prefix(self.argv0)
+
+    # option defaults
+    kwargs = {}
+    kwargs['cxx']     = 'c++'
+    kwargs['heavy']   = 256
+    kwargs['output']  = None
+    kwargs['root']    = '.'
+    kwargs['top']     = 20
+
+    shortopts = "?h"
+    longopts  = ['help', 'cxx=', 'heavy=', 'no-color', 'output=', 'root=',
+                 'top=']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--cxx',):
+          kwargs['cxx'] = optarg
+        elif opt in ('--heavy',):
+          try:
+            kwargs['heavy'] = int(optarg)
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad number.")
+        elif opt in ('--no-color',):
+          self.turn_off_color()
+        elif opt in ('--output',):
+          kwargs['output'] = optarg
+        elif opt in ('--root',):
+          kwargs['root'] = optarg
+        elif opt in ('--top',):
+          try:
+            kwargs['top'] = int(optarg)
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad number.")
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No DEPFILES_FILE specified")
+      sys.exit(2)
+    else:
+      kwargs['depfiles_file'] = args[0]
+
+    kwargs['root'] = os.path.realpath(kwargs['root'])
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    try:
+      with open(self.kwargs['depfiles_file']) as fp:
+        depfiles = [line.strip() for line in fp if line.strip()]
+    except OSError:
+      depfiles = []
+
+    tus = []
+    for path in sorted(set(depfiles)):
+      tus.extend(read_depfile(path))
+
+    if not tus:
+      self.out.warning("No dependencies. Try 'make deps' first.")
+      return 0
+
+    rpt = self.analyze(tus)
+    self.print_report(rpt)
+
+    if self.kwargs['output']:
+      d = os.path.dirname(self.kwargs['output'])
+      if d and not os.path.isdir(d):
+        os.makedirs(d)
+      with open(self.kwargs['output'], 'w') as fp:
+        json.dump(rpt, fp, indent=2, sort_keys=True)
+        fp.write('\n')
+      print(f"\nReport: {self.kwargs['output']}")
+
+    return 0
+
+
+# -----------------------------------------------------------------------------
+app = IncludeMaker()
+sys.exit( app.main(sys.argv) )
+
+
+#/*! \endcond RNMAKE_DOXY */
@@ -0,0 +1,207 @@
+#!/bin/sh
+# Package:  RN Makefile System Utility
+# File:     memgate.sh
+# Desc:     Admit a command (e.g. a compile) only when enough memory is free.
+# Usage:    memgate.sh [OPTIONS] -- cmd [arg...]
+#
+# Parallel make jobs gated by this script wait until the available system
+# memory, less the memory still reserved by other admitted (but still running)
+# gated jobs, covers the job's expected peak memory. The memory a running job
+# already uses is counted in the available memory, so only the rest of its
+# reservation (reservation less the resident memory of its process tree) is
+# still reserved. Light jobs run at full -j while heavy jobs are throttled.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+argv0=$(basename $0)
+
+print_help()
+{
+  cat <<EOH
+Usage: ${argv0} [OPTIONS] -- CMD [ARG...]
+       ${argv0} --help
+
+Run CMD once enough memory is available.
+
+Options:
+  -m, --mem=MB          Expected peak memory of CMD in megabytes. Overrides
+                        any learned value.
+  -d, --default=MB      Expected peak memory if neither --mem nor a learned
+                        value is available. Default: 0 (admit immediately).
+  -r, --record=FILE     Learned peak memory file. If present and --mem is not
+                        specified, its value is the expected peak memory. If
+                        /usr/bin/time is available, the measured peak memory
+                        of a successful CMD is recorded to FILE.
+  -s, --reserve=MB      Memory kept free for the rest of the system.
+                        Default: 256
+      --verbose         Print admission waits.
+
+      --help            Print this help and exit.
+EOH
+}
+
+# long and short options
+longopts="mem:,default:,record:,reserve:,verbose,help"
+shortopts="m:d:r:s:h"
+
+# Option defaults
+mem=
+dftmem=0
+record=
+reserve=256
+verbose=
+
+# get the command-line options
+#   order returned: OPTIONS -- ARGS OTHER_OPTIONS
+OPTS=$(getopt --name ${argv0} -o "${shortopts}" --long "${longopts}" -- "${@}")
+
+if [ $? != 0 ]
+then
+  echo "rnmake: ${argv0}: error: bad option(s), try '${argv0} --help'" >&2
+  exit 2
+fi
+
+eval set -- "${OPTS}"
+
+# process command-line options
+while true
+do
+  case "$1" in
+    -h|--help) print_help; exit 0;;
+    -m|--mem) mem="${2}"; shift 2;;
+    -d|--default) dftmem="${2}"; shift 2;;
+    -r|--record) record="${2}"; shift 2;;
+    -s|--reserve) reserve="${2}"; shift 2;;
+    --verbose) verbose=1; shift;;
+    --) shift; break;;
+    *) break;
+  esac
+done
+
+if [ $# -eq 0 ]
+then
+  echo "rnmake: ${argv0}: error: no command specified" >&2
+  exit 2
+fi
+
+# expected peak memory (MB)
+if [ -z "${mem}" -a -n "${record}" -a -f "${record}" ]
+then
+  mem=$(cat ${record} 2>/dev/null)
+fi
+if [ -z "${mem}" ]
+then
+  mem=${dftmem}
+fi
+
+# reservations of admitted jobs (one file per job, named by pid)
+gatedir=${TMPDIR:-/tmp}/rnmake-memgate.$(id -u)
+lockfile=${gatedir}.lock
+resv=${gatedir}/$$
+
+#
+# Number of live admitted jobs and the sum of their remaining reservations
+# (MB). Stale reservations are removed.
+#
+reserved()
+{
+  live=
+  for f in ${gatedir}/*
+  do
+    test -f "${f}" || continue
+    if kill -0 ${f##*/} 2>/dev/null
+    then
+      live="${live} ${f##*/}:$(cat ${f})"
+    else
+      rm -f ${f}
+    fi
+  done
+  ps -e -o pid=,ppid=,rss= 2>/dev/null | awk -v live="${live}" '
+    { ppid[$1] = $2; rss[$1] = $3 }
+    END {
+      n = split(live, job, " ")
+      for(i = 1; i <= n; ++i)
+      {
+        split(job[i], kv, ":")
+        resv[kv[1]] = kv[2]
+        used[kv[1]] = 0
+      }
+      # resident memory of each job process tree
+      for(pid in rss)
+      {
+        for(p = pid; p + 0 > 1 && !(p in resv); p = ppid[p]) { }
+        if( p in resv ) used[p] += rss[pid]
+      }
+      sum = 0
+      for(p in resv)
+      {
+        left = resv[p] - int(used[p] / 1024)
+        if( left > 0 ) sum += left
+      }
+      print n, sum
+    }'
+}
+
+# available memory (MB)
+available()
+{
+  awk '/^MemAvailable:/ { print int($2 / 1024) }' /proc/meminfo
+}
+
+#
+# Try to admit the job. A job is always admitted if no other gated job is
+# running so that a job larger than memory cannot wait forever.
+#
+admit()
+{
+  (
+    flock 9
+    set -- $(reserved)
+    if [ ${1} -eq 0 ] || [ $(($(available) - ${2} - reserve)) -ge ${mem} ]
+    then
+      echo ${mem} > ${resv}
+      exit 0
+    fi
+    exit 1
+  ) 9>${lockfile}
+}
+
+if [ ${mem} -gt 0 -a -r /proc/meminfo ]
+then
+  test -d ${gatedir} || mkdir -p -m 700 ${gatedir}
+  trap 'rm -f ${resv}' EXIT
+  trap 'exit 130' INT TERM
+  waited=
+  until admit
+  do
+    if [ "${verbose}" -a -z "${waited}" ]
+    then
+      echo "  memgate: waiting for ${mem}MB: ${*}"
+      waited=1
+    fi
+    sleep 0.5
+  done
+fi
+
+# run, measuring peak memory if possible
+if [ -n "${record}" -a -x /usr/bin/time ]
+then
+  peak=$(mktemp ${TMPDIR:-/tmp}/rnmake-memgate-peak.XXXXXX)
+  /usr/bin/time -f '%M' -o ${peak} "${@}"
+  rc=$?
+  if [ ${rc} -eq 0 ]
+  then
+    kb=$(tail -n 1 ${peak})
+    test -d $(dirname ${record}) || mkdir -p -m 775 $(dirname ${record})
+    echo $(( (kb + 1023) / 1024 )) > ${record}
+  fi
+  rm -f ${peak}
+else
+  "${@}"
+  rc=$?
+fi
+
+exit ${rc}
+
+#/*! \endcond RNMAKE_DOXY */
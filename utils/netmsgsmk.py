@@ -0,0 +1,320 @@
+#!/usr/bin/env python3
+#
+# File:
+#   netmsgsmk.py
+#
+# Usage:
+#   netmsgsmk.py [OPTIONS] XML_FILE [XML_FILE...]
+#   netmsgsmk.py --help
+#
+# Description:
+#   Generate NetMsgs C and Python source files of all XML specifications in
+#   one invocation. Generation is skipped for unchanged XML specifications and
+#   generated files are replaced only when their content changes.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+import sys
+import os
+import hashlib
+import subprocess
+import getopt
+from concurrent.futures import ThreadPoolExecutor
+
+# fix up python path
+sys.path.insert(0, os.path.realpath(os.path.dirname(__file__)))
+
+try:
+  from rnmake.color import ColorfulOutput
+except ImportError as e:
+  print(f"{e}: Expeceted to be found in 'PREFIX/rnmake/utils/rnmake'")
+  sys.exit(8)
+
+# supported languages
+Langs = ('c', 'python')
+
+# suffix of backup of a generated file while it is being regenerated
+BackupSuffix = '.netmsgs-bak'
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+def same_content(path1, path2):
+  """ Test if two files have identical content. """
+  try:
+    if os.path.getsize(path1) != os.path.getsize(path2):
+      return False
+    with open(path1, 'rb') as fp1, open(path2, 'rb') as fp2:
+      return fp1.read() == fp2.read()
+  except OSError:
+    return False
+
+# -----------------------------------------------------------------------------
+class NetMsgsMaker:
+  """ Batched, cached NetMsgs source generator class. """
+
+  def __init__(self):
+    self.out    = ColorfulOutput()
+    self.cache  = {}    # (xml, lang) -> content hash
+
+  def outputs(self, xml, lang):
+    """ Generated files of XML specification and language. """
+    base = os.path.splitext(xml)[0]
+    if lang == 'c':
+      return [os.path.join(self.kwargs['hdir'], base + '.h'),
+              os.path.join(self.kwargs['cdir'], base + '.c')]
+    else:
+      return [os.path.join(self.kwargs['pydir'], base + '.py')]
+
+  def command(self, xml, lang):
+    """ Generator command of XML specification and language. """
+    if lang == 'c':
+      flags = self.kwargs['cflags']
+    else:
+      flags = self.kwargs['pyflags']
+    return [self.kwargs['gen'], f"--lang={lang}", f"--xml={xml}"] + \
+           flags.split() + self.outputs(xml, lang)
+
+  def content_hash(self, xml, lang):
+    """ Hash of XML specification content and generator command. """
+    h = hashlib.sha256()
+    h.update('\0'.join(self.command(xml, lang)).encode('utf-8'))
+    with open(xml, 'rb') as fp:
+      h.update(fp.read())
+    return h.hexdigest()
+
+  def read_cache(self):
+    """ Read content hash cache. """
+    try:
+      with open(self.kwargs['cache']) as fp:
+        for line in fp:
+          fields = line.split()
+          if len(fields) == 3:
+            self.cache[(fields[2], fields[1])] = fields[0]
+    except OSError:
+      pass
+
+  def write_cache(self):
+    """ Write content hash cache. """
+    d = os.path.dirname(self.kwargs['cache'])
+    if d and not os.path.isdir(d):
+      os.makedirs(d)
+    tmp = self.kwargs['cache'] + '.tmp'
+    with open(tmp, 'w') as fp:
+      for (xml, lang), digest in sorted(self.cache.items()):
+        fp.write(f"{digest} {lang} {xml}\n")
+    os.replace(tmp, self.kwargs['cache'])
+
+  def generate(self, xml, lang):
+    """
+    Generate source files of XML specification and language. Existing files
+    are kept (content and modification time) if regenerated identically.
+
+    Return:
+      (ok, generator output, list of changed files) tuple.
+    """
+    outputs = self.outputs(xml, lang)
+    for path in outputs:
+      d = os.path.dirname(path)
+      if d and not os.path.isdir(d):
+        os.makedirs(d, exist_ok=True)
+      if os.path.isfile(path):
+        os.replace(path, path + BackupSuffix)
+    completed = subprocess.run(self.command(xml, lang),
+                               stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                               encoding='utf-8', errors='replace')
+    ok = completed.returncode == 0 and all(map(os.path.isfile, outputs))
+    changed = []
+    for path in outputs:
+      bak = path + BackupSuffix
+      if not os.path.isfile(bak):
+        changed.append(path)
+      elif not ok or same_content(path, bak):
+        os.replace(bak, path)
+      else:
+        os.remove(bak)
+        changed.append(path)
+    return ok, completed.stdout, changed
+
+  def fatal(self, ec, *emsgs):
+    """ Show fatal message and exit. """
+    self.out.fatal(*emsgs)
+    sys.exit(ec)
+
+  def turn_off_color(self):
+    """ Disable color output. """
+    self.out.disable_color()
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}")
+    else:
+      print(f"{self.argv0}: error")
+    print(f"Try '{self.argv0} --help' for more information.")
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] XML_FILE [XML_FILE...]
+       {self.argv0} --help
+
+Generate NetMsgs C and Python source files of all XML specifications.
+
+Options:
+      --cache=FILE      Content hash cache file. Generation is skipped for XML
+                        specifications whose content and generator command are
+                        unchanged since the last run. Default: no cache
+
+      --cdir=DIR        Generated .c files output directory. Default: .
+
+      --cflags=FLAGS    Additional generator C flags.
+
+      --gen=CMD         NetMsgs generator command. Default: netmsgsgen
+
+      --hdir=DIR        Generated .h files output directory. Default: .
+
+  -j, --jobs=N          Number of concurrent generator runs. Default: 1
+
+      --langs=LIST      Comma separated list of generated languages.
+                        Default: c,python
+
+      --no-color        Disable color output.
+
+      --pydir=DIR       Generated .py files output directory. Default: .
+
+      --pyflags=FLAGS   Additional generator Python flags.
+
+  -h, --help            Display this help and exit.
+
+Description:
+Existing generated files are replaced only if their content changes, so
+unchanged headers do not trigger recompiles of their includers.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    self.out.set_prefix(self.argv0)
+
+    # option defaults
+    kwargs = {}
+    kwargs['cache']   = None
+    kwargs['cdir']    = '.'
+    kwargs['cflags']  = ''
+    kwargs['gen']     = 'netmsgsgen'
+    kwargs['hdir']    = '.'
+    kwargs['jobs']    = 1
+    kwargs['langs']   = list(Langs)
+    kwargs['pydir']   = '.'
+    kwargs['pyflags'] = ''
+
+    shortopts = "?hj:"
+    longopts  = ['help', 'cache=', 'cdir=', 'cflags=', 'gen=', 'hdir=',
+                 'jobs=', 'langs=', 'no-color', 'pydir=', 'pyflags=']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--cache',):
+          kwargs['cache'] = optarg
+        elif opt in ('--cdir',):
+          kwargs['cdir'] = optarg
+        elif opt in ('--cflags',):
+          kwargs['cflags'] = optarg
+        elif opt in ('--gen',):
+          kwargs['gen'] = optarg
+        elif opt in ('--hdir',):
+          kwargs['hdir'] = optarg
+        elif opt in ('-j', '--jobs'):
+          try:
+            kwargs['jobs'] = max(1, int(optarg))
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad number of jobs.")
+        elif opt in ('--langs',):
+          kwargs['langs'] = [l for l in optarg.replace(',', ' ').split()]
+          for lang in kwargs['langs']:
+            if lang not in Langs:
+              raise UsageError(f"'{lang}': Unsupported language.")
+        elif opt in ('--no-color',):
+          self.turn_off_color()
+        elif opt in ('--pydir',):
+          kwargs['pydir'] = optarg
+        elif opt in ('--pyflags',):
+          kwargs['pyflags'] = optarg
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No XML_FILE specified")
+      sys.exit(2)
+    else:
+      kwargs['xml_files'] = args
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    if self.kwargs['cache']:
+      self.read_cache()
+
+    # jobs of changed or never generated specifications
+    jobs = []
+    for xml in self.kwargs['xml_files']:
+      for lang in self.kwargs['langs']:
+        try:
+          digest = self.content_hash(xml, lang)
+        except OSError as e:
+          self.fatal(8, xml, e.strerror)
+        if self.cache.get((xml, lang)) == digest and \
+            all(map(os.path.isfile, self.outputs(xml, lang))):
+          continue
+        jobs.append((xml, lang, digest))
+
+    nfail = 0
+    with ThreadPoolExecutor(max_workers=self.kwargs['jobs']) as pool:
+      results = pool.map(lambda job: self.generate(job[0], job[1]), jobs)
+      for (xml, lang, digest), (ok, output, changed) in zip(jobs, results):
+        self.out.cprint('normal', f"     {xml} ({lang})")
+        if output:
+          print(output, end='')
+        if ok:
+          self.cache[(xml, lang)] = digest
+          for path in changed:
+            print(f"       {path}")
+        else:
+          self.cache.pop((xml, lang), None)
+          self.out.error(xml, f"Failed to generate {lang} source")
+          nfail += 1
+
+    if self.kwargs['cache']:
+      self.write_cache()
+
+    return 0 if nfail == 0 else 8
+
+
+# -----------------------------------------------------------------------------
+app = NetMsgsMaker()
+sys.exit( app.main(sys.argv) )
+
+
+#/*! \endcond RNMAKE_DOXY */
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+#
+# File:
+#   onlymk.py
+#
+# Usage:
+#   onlymk.py [OPTIONS] INDEX_FILE TARGET [TARGET...]
+#   onlymk.py --help
+#
+# Description:
+#   Make only the given package targets and their library dependencies, each
+#   in its defining directory, from the package target index made by the
+#   rnmake 'only-index' goal.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+import sys
+import os
+import subprocess
+import getopt
+
+# fix up python path
+sys.path.insert(0, os.path.realpath(os.path.dirname(__file__)))
+
+try:
+  from rnmake.color import ColorfulOutput
+except ImportError as e:
+  print(f"{e}: Expeceted to be found in 'PREFIX/rnmake/utils/rnmake'")
+  sys.exit(8)
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+class OnlyMaker:
+  """ Target-scoped build class. """
+
+  def __init__(self):
+    self.out    = ColorfulOutput()
+    self.index  = {}    # target -> (kind, directory, library dependencies)
+
+  def read_index(self):
+    """ Read package target index. """
+    try:
+      with open(self.kwargs['index_file']) as fp:
+        for line in fp:
+          fields = line.split()
+          if len(fields) < 3:
+            continue
+          kind, name, dname = fields[:3]
+          if name in self.index and self.index[name][1] != dname:
+            self.out.warning(name, f"Defined in {self.index[name][1]} and "
+                                   f"{dname}. Using the first.")
+            continue
+          self.index[name] = (kind, dname, fields[3:])
+    except OSError as e:
+      self.fatal(8, self.kwargs['index_file'], e.strerror)
+
+  def closure(self, targets):
+    """
+    Targets and their library dependencies closure, dependencies first.
+
+    Return:
+      List of targets in make order.
+    """
+    order = []
+    state = {}    # target -> 'visiting' or 'done'
+
+    def visit(name, parent):
+      if state.get(name) == 'done':
+        return
+      if state.get(name) == 'visiting':
+        self.fatal(8, name, "Circular library dependency")
+      if name not in self.index:
+        if parent is None:
+          self.fatal(8, name, "Not a target of this package")
+        # external (non-package) library
+        return
+      state[name] = 'visiting'
+      for dep in self.index[name][2]:
+        visit(dep, name)
+      state[name] = 'done'
+      order.append(name)
+
+    for name in targets:
+      visit(name, None)
+    return order
+
+  def make(self, name):
+    """ Make target in its defining directory. """
+    kind, dname, _ = self.index[name]
+    rel = os.path.relpath(dname, self.kwargs['root'])
+    print('')
+    self.out.cprint('info', f"{rel}: {name}")
+    # the sub-make makes just the target, not another target-scoped build
+    env = dict(os.environ)
+    env.pop('RNMAKE_ONLY', None)
+    # keep the make jobserver file descriptors open for the sub-make
+    cmd = self.kwargs['make'].split() + ['--no-print-directory', '-C', dname,
+                                         name]
+    completed = subprocess.run(cmd, env=env, close_fds=False)
+    return completed.returncode == 0
+
+  def fatal(self, ec, *emsgs):
+    """ Show fatal message and exit. """
+    self.out.fatal(*emsgs)
+    sys.exit(ec)
+
+  def turn_off_color(self):
+    """ Disable color output. """
+    self.out.disable_color()
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}")
+    else:
+      print(f"{self.argv0}: error")
+    print(f"Try '{self.argv0} --help' for more information.")
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] INDEX_FILE TARGET [TARGET...]
+       {self.argv0} --help
+
+Make only the given package targets and their LIBDEPS library dependencies,
+each in its defining directory.
+
+Options:
+      --dry-run         Print the make order without making.
+
+      --make=CMD        Make command of each target's sub-make, typically
+                        the invoking $(MAKE).
+                        Default: make
+
+      --no-color        Disable color output.
+
+      --root=DIR        Report directories relative to directory DIR.
+                        Default: .
+
+  -h, --help            Display this help and exit.
+
+Description:
+INDEX_FILE
+Package target index made by the rnmake 'only-index' goal. Each line lists a
+target kind (lib or pgm), name, defining directory, and the names of its
+library dependencies.
+
+TARGET
+Library or program name.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    self.out.set_prefix(self.argv0)
+
+    # option defaults
+    kwargs = {}
+    kwargs['dry_run'] = False
+    kwargs['make']    = 'make'
+    kwargs['root']    = '.'
+
+    shortopts = "?h"
+    longopts  = ['help', 'dry-run', 'no-color', 'make=', 'root=']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--dry-run',):
+          kwargs['dry_run'] = True
+        elif opt in ('--make',):
+          kwargs['make'] = optarg
+        elif opt in ('--no-color',):
+          self.turn_off_color()
+        elif opt in ('--root',):
+          kwargs['root'] = optarg
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No INDEX_FILE specified")
+      sys.exit(2)
+    else:
+      kwargs['index_file'] = args[0]
+
+    if len(args) < 2:
+      self.print_usage_error("No TARGET specified")
+      sys.exit(2)
+    else:
+      kwargs['targets'] = args[1:]
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    self.read_index()
+
+    order = self.closure(self.kwargs['targets'])
+
+    if self.kwargs['dry_run']:
+      for name in order:
+        print(f"{self.index[name][1]}: {name}")
+      return 0
+
+    for name in order:
+      if not self.make(name):
+        self.out.error(name, "Make failed")
+        return 2
+
+    return 0
+
+
+# -----------------------------------------------------------------------------
+app = OnlyMaker()
+sys.exit( app.main(sys.argv) )
+
+
+#/*! \endcond RNMAKE_DOXY */
@@ -20,8 +20,13 @@ import importlib
 import subprocess
 import shutil
 import re
+import io
+import contextlib
+import json
+import hashlib
 import pydoc
 import getopt
+import multiprocessing
 
 from pprint import pprint
 
@@ -38,9 +43,6 @@ except AttributeError as e:
   print(f"{e}")
   sys.exit(8)
 
-# pydoc command in list format
-PyDocCmd = ['pydoc3', '-w']
-
 # image relative path directory url component
 UrlImagePath = 'images'
 
@@ -91,6 +93,24 @@ class UsageError(Exception):
   def __init__(self, msg):
     self.msg = msg
 
+# -----------------------------------------------------------------------------
+def pydoc_write(mod):
+  """
+  Write pydoc html file of module to the current working directory.
+
+  Return:
+    (module, True on success, pydoc output) tuple.
+  """
+  html = mod + '.html'
+  try:
+    os.remove(html)
+  except OSError:
+    pass
+  output = io.StringIO()
+  with contextlib.redirect_stdout(output):
+    pydoc.writedoc(mod)
+  return mod, os.path.isfile(html), output.getvalue()
+
 # -----------------------------------------------------------------------------
 class PyDocMaker:
   """ The pydoc maker class. """
@@ -266,22 +286,45 @@ class PyDocMaker:
             modlist += [rootmod + '.' + mod]
       return modlist
 
-  def make_html_batch_doc(self, mod_batch):
-    if not mod_batch or len(mod_batch) == 0:
-      return 0
-    batch = []
-    for mod in mod_batch:
-      batch += [mod]
-    self.debug('pydoc module batch =', batch)
-    completed = subprocess.run(PyDocCmd + batch) 
-    return completed.returncode
-
-  def make_html_doc(self, mod):
-    if not mod:
-      return 0
-    self.debug('module =', batch)
-    completed = subprocess.run(PyDocCmd + [mod]) 
-    return completed.returncode
+  def module_source(self, mod):
+    """ Module source file (relative to the package parent directory). """
+    path = mod.replace('.', os.sep)
+    if os.path.isdir(path):
+      return os.path.join(path, '__init__.py')
+    else:
+      return path + '.py'
+
+  def module_hash(self, mod):
+    """ Hash of module source and python version. """
+    h = hashlib.sha256(sys.version.encode('utf-8'))
+    try:
+      with open(self.module_source(mod), 'rb') as fp:
+        h.update(fp.read())
+    except OSError:
+      pass
+    return h.hexdigest()
+
+  def read_cache(self):
+    """ Read module source hash cache. """
+    if not self.kwargs['cache']:
+      return {}
+    try:
+      with open(self.kwargs['cache']) as fp:
+        return json.load(fp)
+    except (OSError, ValueError):
+      return {}
+
+  def write_cache(self, cache):
+    """ Write module source hash cache. """
+    if not self.kwargs['cache']:
+      return
+    d = os.path.dirname(self.kwargs['cache'])
+    if d and not os.path.isdir(d):
+      os.makedirs(d)
+    tmp = self.kwargs['cache'] + '.tmp'
+    with open(tmp, 'w') as fp:
+      json.dump(cache, fp, indent=1, sort_keys=True)
+    os.replace(tmp, self.kwargs['cache'])
 
   def make_html_pkg_docs(self):
     self.verbose(f"Making pydoc {self.pkg_info['name']} package documentation")
@@ -300,15 +343,43 @@ class PyDocMaker:
 
     self.debug('py_mod_list =', self.py_mod_list)
 
+    # modules with changed sources or missing html files
+    if self.kwargs['cache']:
+      self.kwargs['cache'] = os.path.abspath(self.kwargs['cache'])
+    old_cache = self.read_cache()
+    cache = {mod: self.module_hash(mod) for mod in self.py_mod_list}
+    html_dir = self.paths['pydoc_html_dir']
+    todo = [mod for mod in self.py_mod_list
+              if old_cache.get(mod) != cache[mod] or
+                 not os.path.isfile(os.path.join(html_dir, mod + '.html'))]
+
+    self.verbose(f"{len(todo)} of {len(self.py_mod_list)} modules changed")
+
     # pydoc outputs html files in current working directory
-    os.chdir(self.paths['pydoc_html_dir'])
+    os.chdir(html_dir)
 
-    # make pydoc html files
-    batch_size = 4
-    i = 0
-    while i < len(self.py_mod_list):
-      self.make_html_batch_doc(self.py_mod_list[i:i+batch_size])
-      i += batch_size
+    # remove html files of removed modules
+    for mod in set(old_cache) - set(cache):
+      try:
+        os.remove(mod + '.html')
+      except OSError:
+        pass
+
+    # make pydoc html files (modules are imported, so one process per job)
+    if self.kwargs['jobs'] > 1 and len(todo) > 1:
+      ctx = multiprocessing.get_context('fork')
+      with ctx.Pool(min(self.kwargs['jobs'], len(todo))) as pool:
+        # results in submission order, so the build log is deterministic
+        results = pool.map(pydoc_write, todo)
+    else:
+      results = [pydoc_write(mod) for mod in todo]
+
+    # failed modules are made again next time
+    for mod, ok, output in results:
+      print(output, end='')
+      if not ok:
+        del cache[mod]
+    self.write_cache(cache)
 
     self.verbose('')
   
@@ -420,11 +491,18 @@ defined in SETUP_PY. The documentation will be created under the
 PYDOC_ROOT path directory.
 
 Options:
+      --cache=FILE      Module source hash cache file. Only modules whose
+                        source changed since the last run are documented.
+                        Default: no cache (all modules are documented)
+
       --debug           Enable debugging.
 
       --images-dir=DIR  Images source directory. Both the logo and favicon must
                         must be found here.
 
+  -j, --jobs=N          Number of modules documented in parallel.
+                        Default: 1
+
       --no-color        Disable color output.
 
       --parent-page=URL Parent URL of generated pydoc index.html.
@@ -456,8 +534,8 @@ Root prefix to make pydoc related documention for distribution.
 
 SETUP__PY
 The SETUP_PY (typically ./setup.py) conforms to the setuptools package.
-It is imported to collect pydoc and package information for the {PyDocCmd[0]}
-utilitiy.
+It is imported to collect pydoc and package information for the pydoc
+module.
 
 VAR=VAL
 The VAR=VAL arguments define additional name-value pairs to be used as working
@@ -479,9 +557,11 @@ See '{self.argv0} --show ref' for referenced variables in template.
     kwargs['verbose'] = False
     kwargs['show']    = []
     kwargs['atat']    = {}
+    kwargs['cache']   = None
+    kwargs['jobs']    = 1
 
-    shortopts = "?h"
-    longopts  = ['help', 'images-src-dir=', 'no-color',
+    shortopts = "?hj:"
+    longopts  = ['help', 'cache=', 'images-src-dir=', 'jobs=', 'no-color',
                  'template=', 'show=', 'debug', 'verbose']
     show_args = ['def', 'ref', 'pre', 'post']
     
@@ -496,6 +576,13 @@ See '{self.argv0} --show ref' for referenced variables in template.
         if opt in ('-h', '--help', '-?'):
           self.print_help()
           sys.exit(0)
+        elif opt in ('--cache',):
+          kwargs['cache'] = optarg
+        elif opt in ('-j', '--jobs'):
+          try:
+            kwargs['jobs'] = max(1, int(optarg))
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad number of jobs.")
         elif opt in ('--no-color'):
           kwargs['color'] = False
           self.turn_off_color()
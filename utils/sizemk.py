@@ -0,0 +1,399 @@
+#!/usr/bin/env python3
+#
+# File:
+#   sizemk.py
+#
+# Usage:
+#   sizemk.py [OPTIONS] TARGETS_FILE
+#   sizemk.py --help
+#
+# Description:
+#   Report binary sizes, largest symbols, template instantiation bloat, and
+#   debug information share of built programs and libraries.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+import sys
+import os
+import re
+import json
+import subprocess
+import getopt
+
+# fix up python path
+sys.path.insert(0, os.path.realpath(os.path.dirname(__file__)))
+
+try:
+  from rnmake.color import ColorfulOutput
+except ImportError as e:
+  print(f"{e}: Expeceted to be found in 'PREFIX/rnmake/utils/rnmake'")
+  sys.exit(8)
+
+# binary tools
+SizeTool    = os.environ.get('SIZE', 'size')
+NmTool      = os.environ.get('NM', 'nm')
+ReadelfTool = os.environ.get('READELF', 'readelf')
+
+# nm symbol types occupying space in the image (code, data, read-only, weak)
+NmSizedTypes = set('TtDdBbRrVvWwu')
+
+# readelf -S -W section line: [Nr] Name Type Address Off Size ...
+ReSection = re.compile(r'^\s*\[\s*\d+\]\s+(\S+)\s+\S+\s+[0-9a-f]+\s+[0-9a-f]+\s+'
+                       r'([0-9a-f]+)')
+
+# size -B -t totals line
+ReTotals = re.compile(r'^\s*(\d+)\s+(\d+)\s+(\d+)\s+\d+\s+[0-9a-f]+\s+'
+                      r'\(TOTALS\)')
+
+# size -B line of a single object
+ReSizes = re.compile(r'^\s*(\d+)\s+(\d+)\s+(\d+)\s+\d+\s+[0-9a-f]+\s')
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+def run(cmd):
+  """
+  Run command.
+
+  Return:
+    Command stdout lines on success, None on failure.
+  """
+  try:
+    completed = subprocess.run(cmd, stdout=subprocess.PIPE,
+                               stderr=subprocess.DEVNULL, encoding='utf-8',
+                               errors='replace')
+  except OSError:
+    return None
+  if completed.returncode != 0:
+    return None
+  return completed.stdout.splitlines()
+
+def strip_template_args(name):
+  """
+  Strip template arguments and function parameters from a demangled name.
+
+  Example:
+    std::vector<int>::push_back(int const&) -> std::vector<>::push_back
+
+  Return:
+    Template family name or None if name is not a template instantiation.
+  """
+  if '<' not in name:
+    return None
+  out = []
+  depth = 0
+  for c in name:
+    if c == '<':
+      if depth == 0:
+        out.append('<>')
+      depth += 1
+    elif c == '>':
+      depth = max(0, depth - 1)
+    elif c == '(' and depth == 0:
+      break
+    elif depth == 0:
+      out.append(c)
+  return ''.join(out).strip()
+
+# -----------------------------------------------------------------------------
+class SizeMaker:
+  """ Binary size reporter class. """
+
+  def __init__(self):
+    self.out = ColorfulOutput()
+
+  def target_sizes(self, path):
+    """ Get text, data, and bss sizes (summed over archive members). """
+    lines = run([SizeTool, '-B', '-t', path])
+    if lines is None:
+      return None
+    for line in reversed(lines):
+      m = ReTotals.match(line) or ReSizes.match(line)
+      if m:
+        return {'text': int(m.group(1)),
+                'data': int(m.group(2)),
+                'bss':  int(m.group(3))}
+    return None
+
+  def target_debug(self, path):
+    """ Get total size of debug sections. """
+    lines = run([ReadelfTool, '-S', '-W', path])
+    if lines is None:
+      return None
+    debug = 0
+    for line in lines:
+      m = ReSection.match(line)
+      if m and m.group(1).startswith(('.debug', '.zdebug')):
+        debug += int(m.group(2), 16)
+    return debug
+
+  def target_symbols(self, path):
+    """ Get defined sized symbols as (size, type, demangled name) tuples. """
+    lines = run([NmTool, '-C', '-S', '--size-sort', '--defined-only', path])
+    if lines is None:
+      return []
+    syms = []
+    for line in lines:
+      fields = line.split(None, 3)
+      if len(fields) < 4 or fields[2] not in NmSizedTypes:
+        continue
+      try:
+        size = int(fields[1], 16)
+      except ValueError:
+        continue
+      syms.append((size, fields[2], fields[3]))
+    return syms
+
+  def template_bloat(self, syms, top):
+    """ Group template instantiations by template family. """
+    groups = {}
+    for size, _, name in syms:
+      family = strip_template_args(name)
+      if family is None:
+        continue
+      g = groups.setdefault(family, {'name': family, 'size': 0, 'count': 0})
+      g['size']  += size
+      g['count'] += 1
+    groups = [g for g in groups.values() if g['count'] > 1]
+    groups.sort(key=lambda g: (-g['size'], g['name']))
+    return groups[:top]
+
+  def report_target(self, path):
+    """ Make size report of one target. """
+    sizes = self.target_sizes(path)
+    if sizes is None:
+      self.out.warning(path, 'Cannot determine sizes')
+      return None
+    rpt = dict(sizes)
+    rpt['total'] = sizes['text'] + sizes['data'] + sizes['bss']
+    rpt['file']  = os.path.getsize(path)
+    debug = self.target_debug(path)
+    rpt['debug'] = debug
+    if debug is not None and rpt['file'] > 0:
+      rpt['debug_pct'] = round(100.0 * debug / rpt['file'], 1)
+    else:
+      rpt['debug_pct'] = None
+    syms = self.target_symbols(path)
+    syms.sort(key=lambda s: (-s[0], s[2]))
+    rpt['symbols'] = [{'name': n, 'type': t, 'size': s}
+                      for s, t, n in syms[:self.kwargs['top']]]
+    rpt['templates'] = self.template_bloat(syms, self.kwargs['top'])
+    return rpt
+
+  def print_target(self, name, rpt):
+    """ Print size report of one target. """
+    self.out.cprint('yellow', name)
+    dbg = '-' if rpt['debug_pct'] is None else f"{rpt['debug_pct']}%"
+    print(f"  text {rpt['text']}  data {rpt['data']}  bss {rpt['bss']}  "
+          f"file {rpt['file']}  debug {dbg}")
+    if rpt['symbols']:
+      print('  largest symbols:')
+      for sym in rpt['symbols']:
+        print(f"    {sym['size']:>8} {sym['type']} {sym['name']}")
+    if rpt['templates']:
+      print('  template bloat:')
+      for g in rpt['templates']:
+        print(f"    {g['size']:>8} x{g['count']:<4} {g['name']}")
+
+  def compare(self, base, targets):
+    """
+    Compare report against base snapshot.
+
+    Return:
+      Number of targets that grew beyond the threshold.
+    """
+    threshold = self.kwargs['threshold']
+    nfail = 0
+    print('')
+    self.out.cprint('yellow', f"Compared to {self.kwargs['base']} "
+                              f"(threshold {threshold}%)")
+    for name, rpt in sorted(targets.items()):
+      if name not in base:
+        print(f"  {'new':>8}  {rpt['total']:>10}  {name}")
+        continue
+      old = base[name]['total']
+      delta = rpt['total'] - old
+      pct = 100.0 * delta / old if old > 0 else 0.0
+      line = f"  {pct:>+7.1f}%  {rpt['total']:>10}  {name} ({delta:+d})"
+      if pct > threshold:
+        self.out.cprint('red', line)
+        nfail += 1
+      else:
+        print(line)
+    for name in sorted(set(base) - set(targets)):
+      print(f"  {'gone':>8}  {'':>10}  {name}")
+    return nfail
+
+  def fatal(self, ec, *emsgs):
+    """ Show fatal message and exit. """
+    self.out.fatal(*emsgs)
+    sys.exit(ec)
+
+  def turn_off_color(self):
+    """ Disable color output. """
+    self.out.disable_color()
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}")
+    else:
+      print(f"{self.argv0}: error")
+    print(f"Try '{self.argv0} --help' for more information.")
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] TARGETS_FILE
+       {self.argv0} --help
+
+Report text, data, and bss sizes, the largest symbols, template instantiation
+bloat, and the debug information share of built programs and libraries.
+
+Options:
+      --base=FILE       Compare against base JSON snapshot FILE.
+
+      --no-color        Disable color output.
+
+      --output=FILE     Write JSON snapshot to FILE.
+
+      --root=DIR        Report target paths relative to directory DIR.
+                        Default: .
+
+      --threshold=PCT   Fail if a target's total size grew more than PCT
+                        percent from the base snapshot. Default: 5
+
+      --top=N           Number of symbols and template groups reported per
+                        target. Default: 10
+
+  -h, --help            Display this help and exit.
+
+Description:
+TARGETS_FILE
+List of built target paths, one per line.
+
+The SIZE, NM, and READELF environment variables override the default size(1),
+nm(1), and readelf(1) binary tools.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    self.out.set_prefix(self.argv0)
+
+    # option defaults
+    kwargs = {}
+    kwargs['base']      = None
+    kwargs['output']    = None
+    kwargs['root']      = '.'
+    kwargs['threshold'] = 5.0
+    kwargs['top']       = 10
+
+    shortopts = "?h"
+    longopts  = ['help', 'base=', 'no-color', 'output=', 'root=',
+                 'threshold=', 'top=']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--base',):
+          kwargs['base'] = optarg
+        elif opt in ('--no-color',):
+          self.turn_off_color()
+        elif opt in ('--output',):
+          kwargs['output'] = optarg
+        elif opt in ('--root',):
+          kwargs['root'] = optarg
+        elif opt in ('--threshold',):
+          try:
+            kwargs['threshold'] = float(optarg)
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad threshold.")
+        elif opt in ('--top',):
+          try:
+            kwargs['top'] = int(optarg)
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad number.")
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No TARGETS_FILE specified")
+      sys.exit(2)
+    else:
+      kwargs['targets_file'] = args[0]
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    # base snapshot (read before a same named output is overwritten)
+    base = None
+    if self.kwargs['base']:
+      try:
+        with open(self.kwargs['base']) as fp:
+          base = json.load(fp)['targets']
+      except (OSError, ValueError, KeyError) as e:
+        self.fatal(8, self.kwargs['base'], f"Bad base snapshot: {e}")
+
+    try:
+      with open(self.kwargs['targets_file']) as fp:
+        paths = [line.strip() for line in fp if line.strip()]
+    except OSError:
+      paths = []
+
+    if not paths:
+      self.out.warning('No built targets. Try make first.')
+
+    targets = {}
+    for path in sorted(set(paths)):
+      name = os.path.relpath(path, self.kwargs['root'])
+      rpt = self.report_target(path)
+      if rpt is not None:
+        targets[name] = rpt
+        self.print_target(name, rpt)
+
+    if self.kwargs['output']:
+      d = os.path.dirname(self.kwargs['output'])
+      if d and not os.path.isdir(d):
+        os.makedirs(d)
+      with open(self.kwargs['output'], 'w') as fp:
+        json.dump({'targets': targets}, fp, indent=2, sort_keys=True)
+        fp.write('\n')
+      print(f"\nSnapshot: {self.kwargs['output']}")
+
+    if base is not None:
+      nfail = self.compare(base, targets)
+      if nfail > 0:
+        self.out.error(f"{nfail} target(s) grew beyond "
+                       f"{self.kwargs['threshold']}%")
+        return 1
+
+    return 0
+
+
+# -----------------------------------------------------------------------------
+app = SizeMaker()
+sys.exit( app.main(sys.argv) )
+
+
+#/*! \endcond RNMAKE_DOXY */
@@ -65,4 +65,5 @@ gawk "
   /\.pyc/             { next }
   /\.pyo/             { next }
   /\.done/            { next }
+  /\.sgrep-index/     { next }
   /.*/                { print \$0 }"
@@ -0,0 +1,129 @@
+#!/bin/sh
+# Package:  RN Makefile System Utility
+# File:     synctree.sh
+# Desc:     Recursively copy files and trees to a destination directory, only
+#           replacing destination files whose content has changed.
+# Usage:    synctree.sh [OPTIONS] src... dstdir
+#
+# Unlike 'cp -r -u', a touched source file with identical content does not
+# update the destination file, so the destination keeps its modification time
+# and anything depending on it (e.g. objects including staged headers) is not
+# rebuilt.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+argv0=$(basename $0)
+
+print_help()
+{
+  cat <<EOH
+Usage: ${argv0} [OPTIONS] SRC [SRC...] DSTDIR
+       ${argv0} --help
+
+Recursively copy files and directory trees SRC... to destination directory
+DSTDIR. A destination file is only (re)written when it does not exist or its
+content differs from the source. Unchanged files keep their modification times.
+
+Options:
+  -w, --what=NOUN       Noun used in the summary line. Default: files
+      --verbose         Print each changed file.
+
+      --help            Print this help and exit.
+EOH
+}
+
+# long and short options
+longopts="what:,verbose,help"
+shortopts="w:h"
+
+# Option defaults
+verbose=
+what=files
+
+# get the command-line options
+#   order returned: OPTIONS -- ARGS OTHER_OPTIONS
+OPTS=$(getopt --name ${argv0} -o "${shortopts}" --long "${longopts}" -- "${@}")
+
+if [ $? != 0 ]
+then
+  echo "rnmake: ${argv0}: error: bad option(s), try '${argv0} --help'" >&2
+  exit 2
+fi
+
+eval set -- "${OPTS}"
+
+# process command-line options
+while true
+do
+  case "$1" in
+    -h|--help) print_help; exit 0;;
+    --verbose) verbose=1; shift;;
+    -w|--what) what="${2}"; shift 2;;
+    --) shift; break;;
+    *) break;
+  esac
+done
+
+if [ $# -lt 2 ]
+then
+  echo "rnmake: ${argv0}: error: no source and/or destination specified" >&2
+  exit 2
+fi
+
+# last argument is the destination directory
+for dstdir; do :; done
+
+test -d ${dstdir} || mkdir -p -m 775 ${dstdir}
+
+nchanged=0
+ntotal=0
+
+#
+# Sync one source file to destination file.
+#
+sync_file()
+{
+  ntotal=$((ntotal + 1))
+  if [ -h "${2}" -o ! -e "${2}" ] || ! cmp -s "${1}" "${2}"
+  then
+    d=$(dirname "${2}")
+    test -d "${d}" || mkdir -p -m 775 "${d}"
+    rm -f "${2}"
+    cp -fp "${1}" "${2}"
+    nchanged=$((nchanged + 1))
+    if [ "${verbose}" ]
+    then
+      echo "  ${2}"
+    fi
+  fi
+}
+
+#
+# Sync all sources. Directories are copied as subtrees of dstdir, like cp -r.
+#
+while [ $# -gt 1 ]
+do
+  src="${1}"
+  shift
+  base=$(basename "${src}")
+  if [ -d "${src}" ]
+  then
+    while read f
+    do
+      test -n "${f}" || continue
+      sync_file "${src}/${f}" "${dstdir}/${base}/${f}"
+    done <<EOF
+$(cd "${src}" && find -L . -type f | sed -e 's%^\./%%' | grep -v '\.svn')
+EOF
+  elif [ -f "${src}" ]
+  then
+    sync_file "${src}" "${dstdir}/${base}"
+  fi
+done
+
+echo "  ${nchanged} of ${ntotal} ${what} changed"
+
+exit 0
+
+#/*! \endcond RNMAKE_DOXY */
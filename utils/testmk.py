@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+#
+# File:
+#   testmk.py
+#
+# Usage:
+#   testmk.py [OPTIONS] BINDIR TEST[:DATA[,DATA...]] [TEST...]
+#   testmk.py --help
+#
+# Description:
+#   Run test programs with result caching. A test is skipped when its binary,
+#   linked libraries, and declared data inputs are unchanged since its last
+#   passing run.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+import sys
+import os
+import json
+import hashlib
+import subprocess
+import getopt
+
+# fix up python path
+sys.path.insert(0, os.path.realpath(os.path.dirname(__file__)))
+
+try:
+  from rnmake.color import ColorfulOutput
+except ImportError as e:
+  print(f"{e}: Expeceted to be found in 'PREFIX/rnmake/utils/rnmake'")
+  sys.exit(8)
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+class TestMaker:
+  """ Cached test runner class. """
+
+  def __init__(self):
+    self.out      = ColorfulOutput()
+    self.digests  = {}    # file -> content hash (memo within one run)
+    self.stats    = {'passed': 0, 'failed': 0, 'cached': 0, 'missing': 0}
+
+  def file_hash(self, path):
+    """ Content hash of file (or of all files under a directory). """
+    if path in self.digests:
+      return self.digests[path]
+    h = hashlib.sha256()
+    if os.path.isdir(path):
+      for root, dirs, files in os.walk(path):
+        dirs.sort()
+        for f in sorted(files):
+          fpath = os.path.join(root, f)
+          h.update(os.path.relpath(fpath, path).encode('utf-8'))
+          h.update(self.file_hash(fpath).encode('utf-8'))
+    else:
+      try:
+        with open(path, 'rb') as fp:
+          for chunk in iter(lambda: fp.read(1 << 20), b''):
+            h.update(chunk)
+      except OSError:
+        h.update(b'\0missing')
+    self.digests[path] = h.hexdigest()
+    return self.digests[path]
+
+  def linked_libs(self, pgm):
+    """ Resolved shared libraries linked by program. """
+    try:
+      completed = subprocess.run(['ldd', pgm], stdout=subprocess.PIPE,
+                                 stderr=subprocess.DEVNULL, encoding='utf-8',
+                                 errors='replace')
+    except OSError:
+      return []
+    libs = []
+    for line in completed.stdout.splitlines():
+      fields = line.split()
+      if '=>' in fields:
+        i = fields.index('=>')
+        if i + 1 < len(fields) and fields[i+1].startswith('/'):
+          libs.append(fields[i+1])
+      elif fields and fields[0].startswith('/'):
+        libs.append(fields[0])
+    return sorted(set(libs))
+
+  def test_key(self, pgm, data):
+    """ Key of test: hash of binary, linked libraries, and data inputs. """
+    h = hashlib.sha256()
+    for path in [pgm] + self.linked_libs(pgm) + data:
+      h.update(path.encode('utf-8'))
+      h.update(self.file_hash(path).encode('utf-8'))
+    return h.hexdigest()
+
+  def read_cache(self):
+    """ Read test results cache. """
+    try:
+      with open(self.kwargs['cache']) as fp:
+        return json.load(fp)
+    except (OSError, ValueError):
+      return {}
+
+  def write_cache(self, cache):
+    """ Write test results cache. """
+    d = os.path.dirname(self.kwargs['cache'])
+    if d and not os.path.isdir(d):
+      os.makedirs(d)
+    tmp = self.kwargs['cache'] + '.tmp'
+    with open(tmp, 'w') as fp:
+      json.dump(cache, fp, indent=1, sort_keys=True)
+    os.replace(tmp, self.kwargs['cache'])
+
+  def run_test(self, name, data, cache):
+    """ Run one test unless cached. """
+    pgm = os.path.join(self.kwargs['bindir'], name)
+    print('')
+    self.out.cprint('info', f"         {name}", end='')
+    if not os.access(pgm, os.X_OK):
+      print('')
+      self.out.error(f"Program {name} does not exist. Did you 'make test' "
+                     "first?")
+      self.stats['missing'] += 1
+      return
+    key = self.test_key(pgm, data)
+    if not self.kwargs['force'] and cache.get(name) == key:
+      print(' (cached)')
+      self.stats['cached'] += 1
+      return
+    print('')
+    sys.stdout.flush()
+    completed = subprocess.run([pgm])
+    if completed.returncode == 0:
+      cache[name] = key
+      self.stats['passed'] += 1
+    else:
+      cache.pop(name, None)
+      self.out.error(name, f"Failed with exit code {completed.returncode}")
+      self.stats['failed'] += 1
+
+  def print_stats(self):
+    """ Print cache statistics summary. """
+    total = sum(self.stats.values())
+    print('')
+    color = 'red' if self.stats['failed'] or self.stats['missing'] else 'info'
+    self.out.cprint(color, f"Tests: {total} total, "
+                           f"{self.stats['passed']} passed, "
+                           f"{self.stats['failed']} failed, "
+                           f"{self.stats['cached']} cached, "
+                           f"{self.stats['missing']} missing")
+
+  def fatal(self, ec, *emsgs):
+    """ Show fatal message and exit. """
+    self.out.fatal(*emsgs)
+    sys.exit(ec)
+
+  def turn_off_color(self):
+    """ Disable color output. """
+    self.out.disable_color()
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}")
+    else:
+      print(f"{self.argv0}: error")
+    print(f"Try '{self.argv0} --help' for more information.")
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] BINDIR TEST[:DATA[,DATA...]] [TEST...]
+       {self.argv0} --help
+
+Run test programs. A test is skipped and reported as cached if its binary,
+linked shared libraries, and data inputs are unchanged since its last passing
+run.
+
+Options:
+      --cache=FILE      Test results cache file. Default: {self.kwargs['cache']}
+
+  -f, --force           Run all tests, ignoring cached results.
+
+      --no-color        Disable color output.
+
+  -h, --help            Display this help and exit.
+
+Description:
+BINDIR
+Directory of the test programs.
+
+TEST[:DATA[,DATA...]]
+Test program name with its optional comma separated data input files or
+directories.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    self.out.set_prefix(self.argv0)
+
+    # option defaults
+    kwargs = {}
+    kwargs['cache'] = 'test-results.cache'
+    kwargs['force'] = False
+    self.kwargs = kwargs
+
+    shortopts = "?hf"
+    longopts  = ['help', 'cache=', 'force', 'no-color']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--cache',):
+          kwargs['cache'] = optarg
+        elif opt in ('-f', '--force'):
+          kwargs['force'] = True
+        elif opt in ('--no-color',):
+          self.turn_off_color()
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No BINDIR specified")
+      sys.exit(2)
+    else:
+      kwargs['bindir'] = args[0]
+
+    kwargs['tests'] = []
+    for arg in args[1:]:
+      name, _, data = arg.partition(':')
+      kwargs['tests'].append((name, [d for d in data.split(',') if d]))
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    cache = self.read_cache()
+
+    for name, data in self.kwargs['tests']:
+      self.run_test(name, data, cache)
+      self.write_cache(cache)
+
+    self.print_stats()
+
+    if self.stats['failed'] or self.stats['missing']:
+      return 1
+    return 0
+
+
+# -----------------------------------------------------------------------------
+app = TestMaker()
+sys.exit( app.main(sys.argv) )
+
+
+#/*! \endcond RNMAKE_DOXY */
@@ -0,0 +1,323 @@
+#!/usr/bin/env python3
+#
+# File:
+#   watchmk.py
+#
+# Usage:
+#   watchmk.py [OPTIONS] PKG_ROOT DIRS_FILE
+#   watchmk.py --help
+#
+# Description:
+#   Watch package source files and continuously rebuild from the flattened
+#   build graph makefiles made by the rnmake 'watch-graph' goal.
+#
+# /*! \file */
+# /*! \cond RNMAKE_DOXY*/
+
+import sys
+import os
+import time
+import shutil
+import subprocess
+import getopt
+
+# fix up python path
+sys.path.insert(0, os.path.realpath(os.path.dirname(__file__)))
+
+try:
+  from rnmake.color import ColorfulOutput
+except ImportError as e:
+  print(f"{e}: Expeceted to be found in 'PREFIX/rnmake/utils/rnmake'")
+  sys.exit(8)
+
+# source filter (same excludes as source tarballs)
+SrcFilter = os.path.join(os.path.realpath(os.path.dirname(__file__)),
+                         'src-filter.sh')
+
+# inotify based wait, if available
+InotifyWait = shutil.which('inotifywait')
+
+# generated paths that never hold sources (reduces inotify wake-ups)
+InotifyExclude = r'/(\.git|\.deps|obj|loc|dist)(/|$)'
+
+# makefile names whose change requires a new build graph
+MakefileNames = ('Makefile', 'makefile', 'GNUmakefile')
+
+
+# -----------------------------------------------------------------------------
+class UsageError(Exception):
+  """ Command-Line Options UsageError Exception Class. """
+  def __init__(self, msg):
+    self.msg = msg
+
+# -----------------------------------------------------------------------------
+class WatchMaker:
+  """ The continuous watch and rebuild class. """
+
+  def __init__(self):
+    self.out      = ColorfulOutput()
+    self.dirs     = []   # build graph directories in build order
+    self.files    = {}   # watched source file -> mtime
+    self.subdirs  = {}   # watched directory -> mtime
+    self.relisted = []   # files added or removed since the last change check
+
+  def read_dirs(self):
+    """ Read the list of directories with build graphs. """
+    try:
+      with open(self.kwargs['dirs_file']) as fp:
+        self.dirs = [line.strip() for line in fp if line.strip()]
+    except OSError as e:
+      self.fatal(8, self.kwargs['dirs_file'], e.strerror)
+
+  def regen(self):
+    """ Regenerate the dependencies and build graph (full rnmake parse). """
+    self.out.info('Regenerating build graph')
+    completed = subprocess.run(self.kwargs['regen'], shell=True,
+                               stdout=subprocess.DEVNULL, env=self.env)
+    if completed.returncode != 0:
+      self.out.error('Build graph regeneration failed')
+    self.read_dirs()
+
+  def scan_tree(self):
+    """ Scan all source files and directories passing the source filter. """
+    root = self.kwargs['pkg_root']
+    completed = subprocess.run([SrcFilter, '.'], cwd=root,
+                               stdout=subprocess.PIPE, encoding='utf-8')
+    self.files = {}
+    self.subdirs = {}
+    for path in completed.stdout.splitlines():
+      path = os.path.normpath(os.path.join(root, path))
+      try:
+        st = os.stat(path)
+      except OSError:
+        continue
+      if os.path.isdir(path):
+        self.subdirs[path] = st.st_mtime_ns
+      else:
+        self.files[path] = st.st_mtime_ns
+
+  def mtime(self, path):
+    try:
+      return os.stat(path).st_mtime_ns
+    except OSError:
+      return None
+
+  def changes(self):
+    """
+    Find changed watched files. Files are re-listed only when a watched
+    directory changed (file added, deleted, or renamed).
+
+    Return:
+      List of changed, added, or removed files.
+    """
+    changed = [f for f, t in self.files.items() if self.mtime(f) != t]
+    self.relisted = []
+    if any(self.mtime(d) != t for d, t in self.subdirs.items()):
+      before = set(self.files)
+      self.scan_tree()
+      self.relisted = list(before.symmetric_difference(self.files))
+      changed += self.relisted
+    else:
+      for f in changed:
+        self.files[f] = self.mtime(f)
+    return sorted(set(changed))
+
+  def wait(self):
+    """ Wait for a file system event or the polling interval. """
+    if InotifyWait and not self.kwargs['poll']:
+      subprocess.run([InotifyWait, '-qq', '-r',
+                      '-t', str(max(1, int(self.kwargs['interval']))),
+                      '-e', 'close_write,create,delete,move',
+                      '--exclude', InotifyExclude,
+                      self.kwargs['pkg_root']],
+                     stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    else:
+      time.sleep(self.kwargs['interval'])
+
+  def build(self):
+    """
+    Rebuild from the flattened build graphs in build order. Make only
+    rebuilds the objects, libraries and programs affected by the changes.
+
+    Return:
+      True on success, False on failure.
+    """
+    t0 = time.time()
+    for d in self.dirs:
+      graph = os.path.join(d, self.kwargs['graph'])
+      if not os.path.isfile(graph):
+        continue
+      completed = subprocess.run(['make', '-s', '--no-print-directory',
+                                  f"-j{self.kwargs['jobs']}",
+                                  '-C', d, '-f', graph], env=self.env)
+      if completed.returncode != 0:
+        self.out.error(os.path.relpath(d, self.kwargs['pkg_root']),
+                       'Build failed')
+        return False
+    self.out.info(f"Rebuilt in {time.time() - t0:.2f}s")
+    return True
+
+  def run(self):
+    """ Watch forever (until interrupted). """
+    self.read_dirs()
+    self.scan_tree()
+    self.out.info(f"Watching {len(self.files)} files in {len(self.dirs)} "
+                  "directories. Press Ctrl-C to stop.")
+    self.build()
+    try:
+      while True:
+        self.wait()
+        changed = self.changes()
+        if not changed:
+          continue
+        for f in changed:
+          self.out.cprint('normal', '  ' +
+                          os.path.relpath(f, self.kwargs['pkg_root']))
+        # the graph rules, generated headers, and .deps follow the makefiles
+        # and the set of source files
+        if self.relisted or \
+            any(os.path.basename(f) in MakefileNames or f.endswith('.mk')
+                for f in changed):
+          self.regen()
+        self.build()
+    except KeyboardInterrupt:
+      print('')
+    return 0
+
+  def fatal(self, ec, *emsgs):
+    """ Show fatal message and exit. """
+    self.out.fatal(*emsgs)
+    sys.exit(ec)
+
+  def turn_off_color(self):
+    """ Disable color output. """
+    self.out.disable_color()
+
+  def print_usage_error(self, *args):
+    """ Print error usage message. """
+    emsg = ': '.join([f"{a}" for a in args])
+    if emsg:
+      print(f"{self.argv0}: error: {emsg}")
+    else:
+      print(f"{self.argv0}: error")
+    print(f"Try '{self.argv0} --help' for more information.")
+
+  def print_help(self):
+    """ Print command-line help. """
+    print(f"""\
+Usage: {self.argv0} [OPTIONS] PKG_ROOT DIRS_FILE
+       {self.argv0} --help
+
+Watch package source files and continuously rebuild from flattened build graph
+makefiles.
+
+Options:
+      --graph=FILE      Build graph makefile path relative to each directory.
+                        Default: {self.kwargs['graph']}
+
+      --interval=SEC    Polling interval in seconds. Default: 1
+
+  -j, --jobs=N          Number of parallel make jobs. Default: 1
+
+      --no-color        Disable color output.
+
+      --poll            Poll even if inotifywait(1) is available.
+
+      --regen=CMD       Command to regenerate the dependencies and build graphs
+                        when a makefile changes or a file is added or removed.
+
+  -h, --help            Display this help and exit.
+
+Description:
+PKG_ROOT
+Package root directory. Source files are the files passing the rnmake
+src-filter.sh filter.
+
+DIRS_FILE
+List of directories with build graphs, one per line, in build order.
+""")
+
+  def get_options(self, argv):
+    """ Get main options and arguments. """
+    self.argv0 = os.path.basename(argv[0])
+
+    self.out.set_prefix(self.argv0)
+
+    # option defaults
+    kwargs = {}
+    kwargs['graph']     = 'watch.mk'
+    kwargs['interval']  = 1.0
+    kwargs['jobs']      = 1
+    kwargs['poll']      = False
+    kwargs['regen']     = None
+    self.kwargs = kwargs
+
+    shortopts = "?hj:"
+    longopts  = ['help', 'graph=', 'interval=', 'jobs=', 'no-color', 'poll',
+                 'regen=']
+
+    # parse command-line options
+    try:
+      try:
+        opts, args = getopt.getopt(argv[1:], shortopts, longopts=longopts)
+      except getopt.error as msg:
+        raise UsageError(msg)
+      for opt, optarg in opts:
+        if opt in ('-h', '--help', '-?'):
+          self.print_help()
+          sys.exit(0)
+        elif opt in ('--graph',):
+          kwargs['graph'] = optarg
+        elif opt in ('--interval',):
+          try:
+            kwargs['interval'] = float(optarg)
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad interval.")
+        elif opt in ('-j', '--jobs'):
+          try:
+            kwargs['jobs'] = int(optarg)
+          except ValueError:
+            raise UsageError(f"'{optarg}': Bad number of jobs.")
+        elif opt in ('--no-color',):
+          self.turn_off_color()
+        elif opt in ('--poll',):
+          kwargs['poll'] = True
+        elif opt in ('--regen',):
+          kwargs['regen'] = optarg
+    except UsageError as err:
+      self.print_usage_error(err.msg)
+      sys.exit(2)
+
+    if len(args) < 1:
+      self.print_usage_error("No PKG_ROOT directory specified")
+      sys.exit(2)
+    else:
+      kwargs['pkg_root'] = os.path.realpath(args[0])
+
+    if len(args) < 2:
+      self.print_usage_error("No DIRS_FILE specified")
+      sys.exit(2)
+    else:
+      kwargs['dirs_file'] = args[1]
+
+    return kwargs
+
+  #--
+  def main(self, argv):
+    """ main """
+    self.kwargs = self.get_options(argv)
+
+    # graph makes are not sub-makes of the invoking make
+    self.env = os.environ.copy()
+    for v in ('MAKEFLAGS', 'MFLAGS', 'MAKELEVEL', 'MAKEOVERRIDES'):
+      self.env.pop(v, None)
+
+    return self.run()
+
+
+# -----------------------------------------------------------------------------
+app = WatchMaker()
+sys.exit( app.main(sys.argv) )
+
+
+#/*! \endcond RNMAKE_DOXY */